@@ -0,0 +1,87 @@
+#ifndef CHANGETRACKING_H
+#define CHANGETRACKING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "StaticVector.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Version of a value produced by a module. The producer increments the version whenever the value changes,
+/// consumers compare it to the version they have seen last.
+/// </summary>
+class ChangeCounter {
+public:
+    uint16_t getVersion() const { return version; }
+
+    void markChanged() { ++version; }
+
+    /// <summary>
+    /// Stores value in current and increments the version if it differs from the stored value.
+    /// </summary>
+    template<typename T>
+    void publish(T& current, const T& value)
+    {
+        if (current != value) {
+            current = value;
+            markChanged();
+        }
+    }
+
+private:
+    uint16_t version = 0;
+};
+
+/// <summary>
+/// Inputs of a consumer module. changed() tells whether any input has a new version since the last call.
+/// A consumer without inputs is never skipped.
+/// </summary>
+template<size_t MaxInputs>
+class ChangeWatch {
+public:
+    /// <summary>
+    /// Replaces the watched inputs, the number of inputs is checked at compile time.
+    /// The next call to changed() returns true.
+    /// </summary>
+    template<typename... Counters>
+    void assign(const Counters&... counters)
+    {
+        inputs.assign(&counters...);
+        seenVersions.assign(counters.getVersion()...);
+        invalidate();
+    }
+
+    bool isWatching() const { return !inputs.empty(); }
+
+    /// <summary>
+    /// Forces the next call to changed() to return true, e.g. after a provider was replaced.
+    /// </summary>
+    void invalidate() { forceUpdate = true; }
+
+    /// <summary>
+    /// Returns true if any input changed since the last call and remembers the current versions.
+    /// </summary>
+    bool changed()
+    {
+        bool result = forceUpdate;
+        forceUpdate = false;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            uint16_t version = inputs[i]->getVersion();
+            if (version != seenVersions[i]) {
+                seenVersions[i] = version;
+                result = true;
+            }
+        }
+        return result;
+    }
+
+private:
+    StaticVector<const ChangeCounter*, MaxInputs> inputs;
+    StaticVector<uint16_t, MaxInputs> seenVersions;
+    bool forceUpdate = true;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef DEADLINEQUEUE_H
+#define DEADLINEQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Returns true if the deadline is reached at currentTimeStamp.
+/// Compares the signed difference, so the result stays correct when millis() wraps around after 49.7 days,
+/// as long as both time stamps are less than half the counter range apart.
+/// </summary>
+inline bool isTimeReached(unsigned long currentTimeStamp, unsigned long deadline)
+{
+    return static_cast<long>(currentTimeStamp - deadline) >= 0;
+}
+
+/// <summary>
+/// Fixed size min-heap of cyclic tasks, ordered by the time stamp of their next run (Task::nextRun).
+/// Every task is registered with a slot number. Tasks with the same deadline are ordered by slot,
+/// so tasks that are due at the same time keep the order in which they were registered.
+/// </summary>
+template<typename Task, size_t Capacity>
+class DeadlineQueue {
+public:
+    /// <summary>
+    /// Adds a task to the queue.
+    /// </summary>
+    /// <returns>false if the queue is full or the task is nullptr</returns>
+    bool push(Task* task, uint8_t slot)
+    {
+        if (!task || count >= Capacity) {
+            return false;
+        }
+        entries[count] = Entry{ task, slot };
+        siftUp(count);
+        ++count;
+        return true;
+    }
+
+    /// <summary>
+    /// Removes the task with the earliest deadline.
+    /// </summary>
+    void pop()
+    {
+        if (count == 0) {
+            return;
+        }
+        --count;
+        entries[0] = entries[count];
+        siftDown(0);
+    }
+
+    /// <summary>
+    /// Restores the heap order after the deadline of a queued task was changed from outside.
+    /// </summary>
+    void update(const Task* task)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            if (entries[i].task == task) {
+                siftUp(i);
+                siftDown(i);
+                return;
+            }
+        }
+    }
+
+    void clear() { count = 0; }
+
+    Task* top() const { return count ? entries[0].task : nullptr; }
+    uint8_t topSlot() const { return count ? entries[0].slot : 0; }
+
+    /// <summary>
+    /// Returns the time stamp of the earliest deadline, 0 if the queue is empty.
+    /// </summary>
+    unsigned long nextDeadline() const { return count ? entries[0].task->nextRun : 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    struct Entry {
+        Task* task;
+        uint8_t slot;
+    };
+
+    static bool before(const Entry& a, const Entry& b)
+    {
+        if (a.task->nextRun != b.task->nextRun) {
+            return !isTimeReached(a.task->nextRun, b.task->nextRun);
+        }
+        return a.slot < b.slot;
+    }
+
+    void siftUp(size_t i)
+    {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(entries[i], entries[parent])) {
+                return;
+            }
+            swap(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i)
+    {
+        while (true) {
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            size_t smallest = i;
+            if (left < count && before(entries[left], entries[smallest])) {
+                smallest = left;
+            }
+            if (right < count && before(entries[right], entries[smallest])) {
+                smallest = right;
+            }
+            if (smallest == i) {
+                return;
+            }
+            swap(i, smallest);
+            i = smallest;
+        }
+    }
+
+    void swap(size_t a, size_t b)
+    {
+        Entry temp = entries[a];
+        entries[a] = entries[b];
+        entries[b] = temp;
+    }
+
+    Entry entries[Capacity];
+    size_t count = 0;
+};
+
+#endif
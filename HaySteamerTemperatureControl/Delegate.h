@@ -0,0 +1,65 @@
+#ifndef DELEGATE_H
+#define DELEGATE_H
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+template<typename Signature>
+class Delegate;
+
+/// <summary>
+/// Lightweight replacement for std::function used to wire the modules together.
+/// The callable is copied into a small buffer inside the delegate and called through a single function pointer,
+/// there is no heap allocation and no virtual call.
+/// Accepted are function pointers and lambdas capturing at most two pointers or references
+/// (e.g. [this] or [&] with up to two variables), which covers all bindings in CyclicCaller.
+/// Larger or not trivially copyable callables are rejected at compile time.
+/// </summary>
+template<typename R, typename... Args>
+class Delegate<R(Args...)> {
+public:
+    static constexpr size_t storageSize = 2 * sizeof(void*);
+
+    Delegate() = default;
+    Delegate(decltype(nullptr)) {}
+
+    template<typename Callable,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Callable>::type, Delegate>::value &&
+            std::is_invocable_r<R, const Callable&, Args...>::value>::type>
+    Delegate(Callable callable)
+    {
+        static_assert(sizeof(Callable) <= storageSize, "Delegate: callable captures too much, capture [this] or references only");
+        static_assert(alignof(Callable) <= alignof(void*), "Delegate: callable alignment not supported");
+        static_assert(std::is_trivially_copyable<Callable>::value, "Delegate: callable must be trivially copyable");
+        ::new (static_cast<void*>(storage)) Callable(callable);
+        invoker = &invoke<Callable>;
+    }
+
+    R operator()(Args... args) const
+    {
+        return invoker(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoker != nullptr; }
+
+private:
+    using Invoker = R(*)(const void*, Args...);
+
+    template<typename Callable>
+    static R invoke(const void* callable, Args... args)
+    {
+        return (*static_cast<const Callable*>(callable))(std::forward<Args>(args)...);
+    }
+
+    alignas(void*) unsigned char storage[storageSize] = {};
+    Invoker invoker = nullptr;
+};
+
+#endif
@@ -1,24 +1,21 @@
 #include "DisplayWriter.h"
 
-DisplayWriter::DisplayWriter(Display126x64* display)
-    : display(display)
+DisplayWriterBase::DisplayWriterBase()
 {
     clearAllLines();
 }
 
-DisplayWriter::~DisplayWriter() {
-}
-
-void DisplayWriter::setAllProvider(ContentProvider line1Provider, ContentProvider line2Provider,
+void DisplayWriterBase::setAllProvider(ContentProvider line1Provider, ContentProvider line2Provider,
     ContentProvider line3Provider, ContentProvider line4Provider)
 {
     m_lineProviders[0] = line1Provider;
     m_lineProviders[1] = line2Provider;
     m_lineProviders[2] = line3Provider;
     m_lineProviders[3] = line4Provider;
+    inputs.invalidate();
 }
 
-void DisplayWriter::setLineProvider(int lineNumber, ContentProvider provider) {
+void DisplayWriterBase::setLineProvider(int lineNumber, ContentProvider provider) {
     if (!isValidLineNumber(lineNumber)) {
         return;
     }
@@ -27,9 +24,10 @@ void DisplayWriter::setLineProvider(int lineNumber, ContentProvider provider) {
     }
 
     m_lineProviders[lineNumber] = provider;
+    inputs.invalidate();
 }
 
-void DisplayWriter::updateLine(int lineNumber) {
+void DisplayWriterBase::updateLine(int lineNumber) {
     if (!isValidLineNumber(lineNumber)) {
         return;
     }
@@ -40,25 +38,22 @@ void DisplayWriter::updateLine(int lineNumber) {
     m_content[lineNumber] = m_lineProviders[lineNumber]();
 }
 
-void DisplayWriter::update() {
+void DisplayWriterBase::updateAllLines() {
     for (int i = 0; i <= 3; ++i) {
         updateLine(i);
     }
-    display->write(m_content);
 }
 
-void DisplayWriter::clearAllLines() {
+void DisplayWriterBase::clearAllLines() {
     for (int i = 0; i <= 3; ++i) {
         m_content[i] = "";
     }
-
-    display->write(m_content);
 }
 
-void DisplayWriter::clearLine(int lineNumber) {
+void DisplayWriterBase::clearLine(int lineNumber) {
     m_content[lineNumber] = "";
 }
 
-bool DisplayWriter::isValidLineNumber(int lineNumber) const {
+bool DisplayWriterBase::isValidLineNumber(int lineNumber) const {
     return lineNumber >= 0 && lineNumber <= 3;
 }
\ No newline at end of file
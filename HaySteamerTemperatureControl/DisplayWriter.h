@@ -1,7 +1,8 @@
 #ifndef DISPLAY_WRITER_H
 #define DISPLAY_WRITER_H
 
-#include <functional>
+#include "Delegate.h"
+#include "ChangeTracking.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -13,7 +14,6 @@
 #endif
 
 #ifdef ARDUINO
-#include <functional>
 // millis() is provided by the Arduino framework, no need to define it
 #include <CyclicModule.h>
 #include <Actor.h>
@@ -22,11 +22,13 @@
 
 using Display126x64 = Actor<String[4]>;
 
-class DisplayWriter : public CyclicModule {
+/// <summary>
+/// Line content and providers of the display writer, independent of the display type.
+/// </summary>
+class DisplayWriterBase : public CyclicModule {
 public:
-    using ContentProvider = std::function<String()>;
-    DisplayWriter(Display126x64* display);
-    ~DisplayWriter();
+    using ContentProvider = Delegate<String()>;
+    DisplayWriterBase();
 
     /// <summary>
 	/// set (and overwrite) content provider for all lines
@@ -40,21 +42,66 @@ public:
     void setLineProvider(int lineNumber, ContentProvider provider);
 
 	/// <summary>
-	/// calls ContentProvider to update all lines and writes to hardware
-    /// call cyclically
+    /// set the versions of the values shown by the providers, update() skips writing while none of them changed.
+    /// without inputs the display is written on every update
 	/// </summary>
-    void update() override;
+    template<typename... Counters>
+    void setInputs(const Counters&... counters)
+    {
+        inputs.assign(counters...);
+    }
 
-private:
+	/// <summary>
+    /// number of writes to the display since construction
+	/// </summary>
+    unsigned long getWriteCount() const { return writeCount; }
+
+protected:
     String m_content[4];
+    ChangeWatch<4> inputs;
+    unsigned long writeCount = 0;
+
+    void clearAllLines();
+    void updateAllLines();
+
+private:
     ContentProvider m_lineProviders[4];
 
     bool isValidLineNumber(int lineNumber) const;
-    void clearAllLines();
     void clearLine(int lineNumber);
     void updateLine(int lineNumber);
+};
+
+/// <summary>
+/// Writes the lines to the display. DisplayType is the interface Display126x64 or the concrete display class.
+/// </summary>
+template<typename DisplayType>
+class BasicDisplayWriter : public DisplayWriterBase {
+public:
+    BasicDisplayWriter(DisplayType* display)
+        : display(display)
+    {
+        display->write(m_content);
+    }
+
+	/// <summary>
+	/// calls ContentProvider to update all lines and writes to hardware
+    /// call cyclically
+	/// </summary>
+    void update() override
+    {
+        if (inputs.isWatching() && !inputs.changed()) {
+            return;
+        }
+        updateAllLines();
+        display->write(m_content);
+        ++writeCount;
+    }
 
-	Display126x64* display;
+private:
+	DisplayType* display;
 };
 
+using DisplayWriter = BasicDisplayWriter<Display126x64>;
+
 #endif
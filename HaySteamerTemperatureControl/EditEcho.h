@@ -0,0 +1,138 @@
+#ifndef EDITECHO_H
+#define EDITECHO_H
+
+#include "ChangeTracking.h"
+#include "DeadlineQueue.h"
+#include "Delegate.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+
+#include "Sandbox/millis.h"
+#include "Sandbox/CyclicModule.h"
+#endif
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <CyclicModule.h>
+#endif
+
+/// <summary>
+/// Switches the outputs to their fast cadence while the user edits parameters.
+/// Runs in the fast input task after the ParameterEditor: when the watched edit state changed,
+/// onEdit is called and the window is (re)started, when the window elapsed without further changes, onTimeout is called.
+/// </summary>
+class FastOutputTrigger : public CyclicModule {
+public:
+    using Action = Delegate<void()>;
+
+    void setActions(Action onEdit, Action onTimeout)
+    {
+        this->onEdit = onEdit;
+        this->onTimeout = onTimeout;
+    }
+
+    void setInput(const ChangeCounter& editState)
+    {
+        input.assign(editState);
+        // the current state is no edit
+        input.changed();
+    }
+
+    void setWindow(unsigned long window_ms) { window = window_ms; }
+    unsigned long getWindow() const { return window; }
+    bool isActive() const { return active; }
+
+    void update() override
+    {
+        unsigned long currentMillis = millis();
+        if (input.changed()) {
+            windowEnd = currentMillis + window;
+            active = true;
+            if (onEdit) onEdit();
+        }
+        else if (active && isTimeReached(currentMillis, windowEnd)) {
+            active = false;
+            if (onTimeout) onTimeout();
+        }
+    }
+
+private:
+    ChangeWatch<1> input;
+    Action onEdit;
+    Action onTimeout;
+    unsigned long window = 5000;
+    unsigned long windowEnd = 0;
+    bool active = false;
+};
+
+/// <summary>
+/// Min/mean/max of a latency in milliseconds.
+/// </summary>
+struct LatencyStatistics {
+    void record(unsigned long latency)
+    {
+        ++count;
+        total += latency;
+        if (latency < min) min = latency;
+        if (latency > max) max = latency;
+    }
+
+    unsigned long getMean() const { return count ? total / count : 0; }
+
+    void reset() { *this = LatencyStatistics(); }
+
+    unsigned long count = 0;
+    unsigned long min = ~0UL;
+    unsigned long max = 0;
+    unsigned long total = 0;
+};
+
+/// <summary>
+/// Measures the time from the key interrupt to the display write showing the key.
+/// keyProcessed() is called with the time stamp of every key taken by the editor,
+/// update() runs in the output task after the display writer and records the latency of the oldest key
+/// not shown yet, as soon as the display was written.
+/// </summary>
+class KeyEchoProbe : public CyclicModule {
+public:
+    using WriteCounter = Delegate<unsigned long()>;
+
+    void setWriteCounter(WriteCounter counter)
+    {
+        displayWrites = counter;
+        if (displayWrites) seenWrites = displayWrites();
+    }
+
+    void keyProcessed(unsigned long keyTimeStamp)
+    {
+        if (!pending) {
+            pending = true;
+            pendingKeyTime = keyTimeStamp;
+        }
+    }
+
+    void update() override
+    {
+        if (!displayWrites) return;
+        unsigned long writes = displayWrites();
+        if (writes == seenWrites) return;
+        seenWrites = writes;
+        if (pending) {
+            pending = false;
+            statistics.record(millis() - pendingKeyTime);
+        }
+    }
+
+    const LatencyStatistics& getStatistics() const { return statistics; }
+    void reset() { statistics.reset(); pending = false; }
+
+private:
+    WriteCounter displayWrites;
+    unsigned long seenWrites = 0;
+    bool pending = false;
+    unsigned long pendingKeyTime = 0;
+    LatencyStatistics statistics;
+};
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef FAULTCONDITIONS_H
 #define FAULTCONDITIONS_H
 
-#include <functional>
-#include <string>
-#include <vector>
+#include "Delegate.h"
+#include "StaticVector.h"
+#include "Messages.h"
+#include "ProcessImage.h"
+#include "StateMachine.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -16,36 +18,117 @@
 #include "Status.h"
 #endif
 
+/// <summary>
+/// Fault rules of the process. Every rule declares the states it applies to, its priority and its condition,
+/// which reads its inputs from the process image of the logic run or from a detector.
+/// An index per state lists the rules of that state by priority, so a logic run only evaluates the rules of the
+/// current state and stops at the first one met.
+/// </summary>
 class FaultConditions {
 public:
-    using FaultCondition = std::function<bool(Status)>;
+    using FaultCondition = Delegate<bool(const ProcessImage&)>;
+    using DetectorInput = Delegate<void(const ProcessImage&)>;
+    using StateMask = uint8_t;
+    static constexpr size_t maxConditions = 16;
+    static constexpr size_t maxDetectors = 8;
+    static constexpr StateMask allStates = (1u << HaySteamerStateMachine::statusCount) - 1;
+    static constexpr uint8_t defaultPriority = 0;
 
     /// <summary>
-    /// Adds a fault condition and its associated message to the conditions list if the condition is valid.
+    /// Adds a fault rule if the condition is valid.
     /// </summary>
     /// <param name="condition">The fault condition to add.</param>
-    /// <param name="message">The message associated with the fault condition.</param>
-    void addCondition(FaultCondition condition, const String& message) {
-        if (!condition) return;
-        conditions.emplace_back(condition, message);
+    /// <param name="message">The message associated with the fault condition, a string literal, only the pointer is kept.</param>
+    /// <param name="states">The states the rule applies to, statusBit() of each state.</param>
+    /// <param name="priority">Rules with a higher priority are checked first, equal priorities in the order they were added.</param>
+    /// <returns>false if the condition is empty or maxConditions conditions are added already.</returns>
+    bool addCondition(FaultCondition condition, const char* message, StateMask states = allStates, uint8_t priority = defaultPriority) {
+        if (!condition) return false;
+        if (!rules.push_back(Rule{ condition, message ? message : "", states, priority })) return false;
+
+        const uint8_t position = static_cast<uint8_t>(rules.size() - 1);
+        for (size_t state = 0; state < HaySteamerStateMachine::statusCount; ++state) {
+            if (states & (1u << state)) {
+                insertIntoIndex(state, position);
+            }
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Adds the input of a streaming detector (see FaultDetectors.h). It is fed with every process image,
+    /// whatever the state, before the rules are checked, so the detector does not miss samples
+    /// when its rule is not evaluated.
+    /// </summary>
+    /// <returns>false if the input is empty or maxDetectors inputs are added already.</returns>
+    bool addDetector(DetectorInput input) {
+        if (!input) return false;
+        return detectors.push_back(input);
+    }
+
+    /// <summary>
+    /// Feeds all detectors with the process image, call once per logic run before checkConditions().
+    /// </summary>
+    void sampleDetectors(const ProcessImage& image) const {
+        for (const DetectorInput& detector : detectors) {
+            detector(image);
+        }
     }
 
     /// <summary>
-    /// Checks all fault conditions and returns the message of the first condition that is met.
+    /// Checks the rules of the state by priority and returns the code of the first rule that is met.
     /// </summary>
-    /// <returns>The message of the first met condition, or empty string if none are met.</returns>
-    String checkConditions(Status state) const {
-        for (size_t i = 0; i < conditions.size(); i++) {
-            const auto& condition_pair = conditions[i];
-            if (condition_pair.first(state)) {
-                return condition_pair.second;
+    /// <returns>The code of the first met rule, its position starting at 1, or noFault if none are met.</returns>
+    FaultCode checkConditions(Status state, const ProcessImage& image) const {
+        const size_t stateIndex = static_cast<size_t>(state);
+        for (uint8_t i = 0; i < indexSize[stateIndex]; ++i) {
+            const uint8_t position = index[stateIndex][i];
+            if (rules[position].condition(image)) {
+                return static_cast<FaultCode>(position + 1);
             }
         }
-        return "";
+        return noFault;
+    }
+
+    /// <summary>
+    /// Message of a fault code.
+    /// </summary>
+    /// <returns>The message of the rule, empty for noFault or an unknown code.</returns>
+    const char* getMessage(FaultCode code) const {
+        if (code == noFault || code > rules.size()) {
+            return "";
+        }
+        return rules[code - 1].message;
+    }
+
+    // number of rules checked in the state
+    size_t getRuleCount(Status state) const {
+        return indexSize[static_cast<size_t>(state)];
     }
 
 private:
-    std::vector<std::pair<FaultCondition, String>> conditions;
+    struct Rule {
+        FaultCondition condition;
+        const char* message = "";
+        StateMask states = allStates;
+        uint8_t priority = defaultPriority;
+    };
+
+    // keeps the rules of a state sorted by priority, a new rule goes behind the rules of the same priority
+    void insertIntoIndex(size_t state, uint8_t position) {
+        uint8_t* rulesOfState = index[state];
+        uint8_t i = indexSize[state]++;
+        while (i > 0 && rules[rulesOfState[i - 1]].priority < rules[position].priority) {
+            rulesOfState[i] = rulesOfState[i - 1];
+            --i;
+        }
+        rulesOfState[i] = position;
+    }
+
+    StaticVector<Rule, maxConditions> rules;
+    StaticVector<DetectorInput, maxDetectors> detectors;
+    uint8_t index[HaySteamerStateMachine::statusCount][maxConditions] = {};
+    uint8_t indexSize[HaySteamerStateMachine::statusCount] = {};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,183 @@
+#ifndef FAULTDETECTORS_H
+#define FAULTDETECTORS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SensorFilters.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+// Streaming fault detectors: every sample takes constant time, the memory is fixed by the template parameters.
+// They are fed once per logic run, see FaultConditions::addDetector(), and read by fault rules.
+
+/// <summary>
+/// Least squares slope of the last Window samples, taken at a fixed sample period.
+/// The sums are updated when a sample enters and leaves the window, no pass over the window is needed.
+/// T is an integer or a Temperature, the sums are kept on its raw integer (see FilterRaw),
+/// so the slope of a Temperature keeps the hundredths of a degree.
+/// </summary>
+template<typename T, size_t Window>
+class RollingSlope {
+public:
+    static_assert(Window >= 2, "a slope needs at least two samples");
+
+    explicit RollingSlope(unsigned long samplePeriod_ms)
+        : samplePeriod(samplePeriod_ms)
+    { }
+
+    void update(T value)
+    {
+        const long raw = FilterRaw<T>::toRaw(value);
+        if (count == Window) {
+            // the oldest sample leaves, the index of every other sample goes down by one
+            sum -= samples[next];
+            weightedSum -= sum;
+        }
+        else {
+            ++count;
+        }
+        samples[next] = raw;
+        next = (next + 1) % Window;
+        weightedSum += static_cast<long>(count - 1) * raw;
+        sum += raw;
+    }
+
+    bool isFull() const { return count == Window; }
+
+    // change per minute, rounded to the raw unit of T, 0 until two samples are in
+    T getSlopePerMinute() const
+    {
+        if (count < 2 || samplePeriod == 0) return FilterRaw<T>::fromRaw(0);
+        // all sums are whole numbers, the slope is divided once at the end, in 64 bit to keep the range on the AVR
+        const long long n = static_cast<long long>(count);
+        const long long indexSum = n * (n - 1) / 2;
+        const long long indexSquareSum = (n - 1) * n * (2 * n - 1) / 6;
+        const long long numerator = (n * weightedSum - indexSum * sum) * 60000LL;
+        const long long denominator = (n * indexSquareSum - indexSum * indexSum) * static_cast<long long>(samplePeriod);
+        const long long half = denominator / 2;
+        return FilterRaw<T>::fromRaw(static_cast<long>(numerator < 0 ? (numerator - half) / denominator : (numerator + half) / denominator));
+    }
+
+    void reset()
+    {
+        count = 0;
+        next = 0;
+        sum = 0;
+        weightedSum = 0;
+    }
+
+private:
+    long samples[Window] = {};
+    size_t count = 0;
+    size_t next = 0;
+    long sum = 0;          // sum of the raw samples
+    long weightedSum = 0;  // sum of index * raw sample, the oldest sample has index 0
+    unsigned long samplePeriod;
+};
+
+/// <summary>
+/// Trips when at least tripCount of the last Window samples hit, and clears again when at most clearCount do.
+/// A single outlier does not trip it, a single good sample does not clear it.
+/// </summary>
+template<uint8_t Window>
+class NOfM {
+public:
+    static_assert(Window >= 1 && Window <= 32, "the samples are kept in a 32 bit mask");
+
+    NOfM(uint8_t tripCount, uint8_t clearCount)
+        : tripCount(tripCount), clearCount(clearCount)
+    { }
+
+    bool update(bool hit)
+    {
+        const uint32_t leaving = (history >> (Window - 1)) & 1u;
+        if (samples == Window) {
+            hits -= leaving;
+        }
+        else {
+            ++samples;
+        }
+        history = ((history << 1) | (hit ? 1u : 0u)) & mask;
+        hits += hit ? 1 : 0;
+
+        if (!active && hits >= tripCount) active = true;
+        else if (active && hits <= clearCount) active = false;
+        return active;
+    }
+
+    bool isActive() const { return active; }
+    uint8_t getHits() const { return hits; }
+
+    void reset()
+    {
+        history = 0;
+        samples = 0;
+        hits = 0;
+        active = false;
+    }
+
+private:
+    static constexpr uint32_t mask = Window == 32 ? 0xFFFFFFFFu : ((1u << Window) - 1);
+    uint32_t history = 0;   // newest sample in bit 0
+    uint8_t samples = 0;
+    uint8_t hits = 0;
+    uint8_t tripCount;
+    uint8_t clearCount;
+    bool active = false;
+};
+
+/// <summary>
+/// Trips when the value did not rise by at least minRise within window (ms).
+/// Keeps only the reference value and the time it was set, every rise by minRise moves the reference up.
+/// T is an integer or a Temperature, with a Temperature the rise may be a fraction of a degree.
+/// A window of 0 turns the detector off.
+/// </summary>
+template<typename T>
+class NoRiseDetector {
+public:
+    NoRiseDetector(T minRise, unsigned long window_ms)
+        : minRise(minRise), window(window_ms)
+    { }
+
+    bool update(T value, unsigned long timeStamp)
+    {
+        if (!started || value >= reference + minRise) {
+            started = true;
+            reference = value;
+            referenceTime = timeStamp;
+        }
+        active = window > 0 && timeStamp - referenceTime >= window;
+        return active;
+    }
+
+    bool isActive() const { return active; }
+
+    // new limits start a new window
+    void setLimits(T newMinRise, unsigned long window_ms)
+    {
+        minRise = newMinRise;
+        window = window_ms;
+        reset();
+    }
+
+    T getMinRise() const { return minRise; }
+    unsigned long getWindow() const { return window; }
+
+    void reset()
+    {
+        started = false;
+        active = false;
+    }
+
+private:
+    T minRise;
+    unsigned long window;
+    T reference{};
+    unsigned long referenceTime = 0;
+    bool started = false;
+    bool active = false;
+};
+
+#endif
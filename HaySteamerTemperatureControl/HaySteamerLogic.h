@@ -1,8 +1,14 @@
 #ifndef HAYSTEAMERLOGIC_H
 #define HAYSTEAMERLOGIC_H
 
-#include <functional>
+#include "Delegate.h"
+#include "ChangeTracking.h"
 #include "StateMachine.h"
+#include "ProcessImage.h"
+#include "Messages.h"
+#include "FaultConditions.h"
+#include "FaultDetectors.h"
+#include "TimeWindow.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -18,166 +24,197 @@
 class HaySteamerLogic : public CyclicModule
 {
 public:
+    using Capture = Delegate<void(ProcessImage&)>;
+    // the built-in faults are checked before the attached ones
+    static constexpr uint8_t builtInFaultPriority = 100;
+
+    HaySteamerLogic()
+    {
+        // a temperature drop needs two of the last three samples, a single noisy reading does not stop the run
+        faults.addDetector([this](const ProcessImage& image) {
+            temperatureDrop.update(image.getTemperature() < minimumTemperature - holdingTemperatureDrop);
+        });
+        // heating stalls if the temperature does not rise within the stall window, long before the heating timeout
+        faults.addDetector([this](const ProcessImage& image) { heatingStall.update(image.getTemperature(), image.timeStamp); });
+        // a probe that disagrees with the others in several of the last samples stops the run, the readings cannot be trusted;
+        // only while holding: during heating a cold core probe lags the probe near the steam by far more than the outlier limit
+        faults.addDetector([this](const ProcessImage& image) { probeDisagreement.update(image.probesDisagree); });
+        stateMachine.setOnEntry(Status::holding, [this](Status) { temperatureDrop.reset(); probeDisagreement.reset(); });
+        // an open or no longer sampled probe stops the run: a dead cold spot probe would raise the fused minimum,
+        // with all probes dead the temperature would stay frozen
+        faults.addDetector([this](const ProcessImage& image) { probeFailure.update(image.failedProbes != 0); });
+        stateMachine.setOnEntry(Status::heating, [this](Status) { heatingStall.reset(); probeFailure.reset(); });
+
+        faults.addCondition([this](const ProcessImage& image) { return TimeWindow::minutesSince(actualStartTime, image.timeOfDayInMinutes) > heatingTimeout; },
+            getMessageText(MessageId::heatingTimeout), statusBit(Status::heating), builtInFaultPriority);
+        faults.addCondition([this](const ProcessImage&) { return heatingStall.isActive(); },
+            getMessageText(MessageId::heatingStalled), statusBit(Status::heating), builtInFaultPriority);
+        faults.addCondition([this](const ProcessImage&) { return temperatureDrop.isActive(); },
+            getMessageText(MessageId::temperatureDrop), statusBit(Status::holding), builtInFaultPriority);
+        faults.addCondition([this](const ProcessImage&) { return probeDisagreement.isActive(); },
+            getMessageText(MessageId::probesDisagree), statusBit(Status::holding), builtInFaultPriority);
+        faults.addCondition([this](const ProcessImage&) { return probeFailure.isActive(); },
+            getMessageText(MessageId::probeFailed), statusBit(Status::heating) | statusBit(Status::holding), builtInFaultPriority);
+    }
+    // the built-in fault rules refer to this object
+    HaySteamerLogic(const HaySteamerLogic&) = delete;
+    HaySteamerLogic& operator=(const HaySteamerLogic&) = delete;
+
+    // captures the process image and runs the logic on it
     void update() override
     {
+        if (capture) {
+            capture(image);
+        }
+        update(image);
+    }
+
+    // one logic run, all decisions are based on the given snapshot of the inputs
+    void update(const ProcessImage& image)
+    {
+        const Status previousStatus = stateMachine.getCurrentStatus();
+
         switch (stateMachine.getCurrentStatus()) {
         case Status::idle:
             if (startConditions())
             {
-                actualStartTime = getTimeOfDayInMinutes();
+                actualStartTime = image.timeOfDayInMinutes;
                 stateMachine.changeStatus(Status::heating);
-                message = "heating";
-                minimumTemperature = getMinimumTemperature();
+                message = getMessageText(MessageId::heating);
+                minimumTemperature = image.minimumTemperature;
             }
-            else if (startTimer())
+            else if (image.startButton)
             {
                 stateMachine.changeStatus(Status::ready);
-                message = "ready";
+                message = getMessageText(MessageId::ready);
             }
 			break;
 
         case Status::ready:
             if (runTimer())
             {
-				actualStartTime = getTimeOfDayInMinutes();
+				actualStartTime = image.timeOfDayInMinutes;
                 stateMachine.changeStatus(Status::heating);
-				message = "heating";
-				minimumTemperature = getMinimumTemperature();
+				message = getMessageText(MessageId::heating);
+				minimumTemperature = image.minimumTemperature;
             }
             break;
         case Status::heating:
-            if (getTemperature() >= minimumTemperature)
+            if (image.getTemperature() >= minimumTemperature)
             {
-				reachedMinimumTemperature = getTimeOfDayInMinutes();
+				reachedMinimumTemperature = image.timeOfDayInMinutes;
                 stateMachine.changeStatus(Status::holding);
-                message = "holding";
-				waitTime = getWaitTime();
+                message = getMessageText(MessageId::holding);
+				waitTime = image.waitTime;
             }
             break;
         case Status::holding:
-            if (getTimeOfDayInMinutes() - reachedMinimumTemperature >= waitTime)
+            if (TimeWindow::minutesSince(reachedMinimumTemperature, image.timeOfDayInMinutes) >= waitTime)
             {
-				timeWhenDone = getTimeOfDayInMinutes();
+				timeWhenDone = image.timeOfDayInMinutes;
                 stateMachine.changeStatus(Status::done);
-                message = "done";
+                message = getMessageText(MessageId::done);
             }
             break;
         case Status::done:
             // signal done for an hour, the go back to idle
-            if (getTimeOfDayInMinutes() - timeWhenDone >= 60)
+            if (TimeWindow::minutesSince(timeWhenDone, image.timeOfDayInMinutes) >= 60)
             {
                 stateMachine.changeStatus(Status::idle);
-				message = "idle";
+				message = getMessageText(MessageId::idle);
 
             }
             break;
         }
 
-		checkFaults();
-    }
+		checkFaults(image);
 
-    void setStartConditions(std::function<bool()> conditions) 
-    { 
-        if (!conditions) {
-            return;
-		}
-        startConditions = conditions; 
-    }
-    void setStartTimer(std::function<bool()> func)
-    {
-        if (!func) {
-            return;
+        // the messages of the states change together with the status, fault messages are published in checkFaults()
+        if (stateMachine.getCurrentStatus() != previousStatus) {
+            changes.markChanged();
         }
-        startTimer = func;
     }
-    void setRunTimer(std::function<bool()> func)
+
+    // fills the process image at the start of every logic run
+    void setCapture(Capture captureInputs)
     {
-        if (!func) {
+        if (!captureInputs) {
             return;
         }
-        runTimer = func;
+        capture = captureInputs;
     }
-    void setHasFault(std::function<String(Status)> faultCondition) 
+    void setStartConditions(Delegate<bool()> conditions) 
     { 
-        if (!faultCondition) {
-            return;
-        }
-        hasFault = faultCondition; 
-        }
-    void setGetTimeOfDayInMinutes(std::function<unsigned long()> timeFunction) 
-    { 
-        if (!timeFunction) {
+        if (!conditions) {
             return;
 		}
-        getTimeOfDayInMinutes = timeFunction; 
+        startConditions = conditions; 
     }
-    void setGetTemperature(std::function<int()> temperatureFunction) 
-    { 
-        if (!temperatureFunction) {
+    void setRunTimer(Delegate<bool()> func)
+    {
+        if (!func) {
             return;
         }
-        getTemperature = temperatureFunction; 
+        runTimer = func;
     }
-    void setGetMinimumTemperature(std::function<int()> getMinTemp) 
-    { 
-        if (!getMinTemp) {
-            return;
-		}
-        getMinimumTemperature = getMinTemp; 
+    // attaches a fault rule, see FaultConditions::addCondition()
+    bool addFaultCondition(FaultConditions::FaultCondition condition, const char* message,
+        FaultConditions::StateMask states = FaultConditions::allStates, uint8_t priority = FaultConditions::defaultPriority)
+    {
+        return faults.addCondition(condition, message, states, priority);
     }
-    void setGetWaitTime(std::function<unsigned long()> getTimeSpan) 
-    { 
-        if (!getTimeSpan) {
-            return;
-        }
-        getWaitTime = getTimeSpan; 
+
+    // the heating stalls if the temperature does not rise by minRise within window_ms,
+    // a big bale may need a longer window early in the heating, a window of 0 turns the fault off
+    void setHeatingStallLimits(Temperature minRise, unsigned long window_ms)
+    {
+        heatingStall.setLimits(minRise, window_ms);
     }
+    Temperature getHeatingStallRise() const { return heatingStall.getMinRise(); }
+    unsigned long getHeatingStallWindow() const { return heatingStall.getWindow(); }
 
-    String getMessage() const { return message; }
+    // text of the current message, points into flash, valid for the whole run time
+    const char* getMessage() const { return message; }
 	Status getCurrentStatus() const { return stateMachine.getCurrentStatus(); }
+    // version of status and message
+    const ChangeCounter& getChangeCounter() const { return changes; }
+    // feeds a streaming detector with every process image, see FaultConditions::addDetector()
+    bool addFaultDetector(FaultConditions::DetectorInput input)
+    {
+        return faults.addDetector(input);
+    }
+
+    // hooks on the state transitions, e.g. to drive outputs by transitions instead of polling the status
+    // the logic uses the entry hooks of heating and holding itself
+    void setOnEntry(Status status, HaySteamerStateMachine::Hook hook) { stateMachine.setOnEntry(status, hook); }
+    void setOnExit(Status status, HaySteamerStateMachine::Hook hook) { stateMachine.setOnExit(status, hook); }
+    uint16_t getTransitionCount(Status from, Status to) const { return stateMachine.getTransitionCount(from, to); }
+    // inputs of the last logic run, the start and fault conditions read them from here
+    const ProcessImage& getProcessImage() const { return image; }
 	
 private:
-    std::function<bool()> startConditions;
-    std::function<bool()> startTimer;
-    std::function<bool()> runTimer;
-	std::function<String(Status)> hasFault;
-    void checkFaults()
+    Delegate<bool()> startConditions = []() { return false; };
+    Delegate<bool()> runTimer = []() { return false; };
+    // only the rules of the current state are checked, the first one met by priority sets the message
+    void checkFaults(const ProcessImage& image)
     {
-        String errorMessage = "";
-        switch (stateMachine.getCurrentStatus()) {
-        case Status::heating:
-            if (getTimeOfDayInMinutes() - actualStartTime > heatingTimeout)
-            {
-                stateMachine.changeStatus(Status::error);
-                errorMessage = "heating timeout";
-            }
-            break;
-        case Status::holding:
-            if (getTemperature() < minimumTemperature - holdingTemperatureDrop)
-            {
-                stateMachine.changeStatus(Status::error);
-                errorMessage = "temperature drop";
-            }
-            break;
-        }
-
-        if (errorMessage == "")
-        {
-            errorMessage = hasFault(stateMachine.getCurrentStatus());
-        }
-
-        if (errorMessage != "")
+        faults.sampleDetectors(image);
+        const FaultCode fault = faults.checkConditions(stateMachine.getCurrentStatus(), image);
+        if (fault != noFault)
         {
             stateMachine.changeStatus(Status::error);
-            message = errorMessage;
+            changes.publish(message, faults.getMessage(fault));
         }
-        return;
     }
-	std::function<unsigned long()> getTimeOfDayInMinutes;
-	std::function<int()> getTemperature;
+
+    FaultConditions faults;
 
 	HaySteamerStateMachine stateMachine;
-    String message = "idle";
+    const char* message = getMessageText(MessageId::idle);
+    ChangeCounter changes;
+
+    Capture capture;
+    ProcessImage image;
 
     // track process
     unsigned long actualStartTime = 0;
@@ -185,12 +222,16 @@ private:
     unsigned long timeWhenDone = 0;
 	// parameters for detecting faults
     unsigned long heatingTimeout = 60;
-    int holdingTemperatureDrop = 5;
-    // Parameters for the hay steaming process
-	std::function<int()> getMinimumTemperature = []() { return 60; };
-	int minimumTemperature;
-	std::function<unsigned long()> getWaitTime = []() { return 30; };
-    unsigned long waitTime;
+    Temperature holdingTemperatureDrop = 5_degC;
+    NOfM<3> temperatureDrop{ 2, 0 };
+    static constexpr Temperature defaultStallRise = 1_degC;
+    static constexpr unsigned long defaultStallWindow = 15UL * 60000; // 15 minutes
+    NoRiseDetector<Temperature> heatingStall{ defaultStallRise, defaultStallWindow };
+    NOfM<5> probeDisagreement{ 3, 0 };
+    NOfM<3> probeFailure{ 2, 0 };
+    // parameters of the running process, taken from the process image when the phase starts
+	Temperature minimumTemperature = 60_degC;
+    unsigned long waitTime = 30;
 };
 
 #endif
\ No newline at end of file
@@ -10,12 +10,20 @@
 #include <Keypad.h>
 
 #include "TaskScheduler.h"
+#include "ProbeSampler.h"
+#include "SensorFilters.h"
 
 Communication com;
 NTP_Time clk;
 TempProbe temp(5, 7, 4, 5, 8, 4);
+// collects the probes between the tasks, the slow input task only picks up the latest samples
+ProbeSampler<TempProbe> temp_sampler(&temp);
+// removes single spikes and the quantization noise before the logic and the display see the temperature,
+// on the 1 s samples a step is half through after 2 s and within a quarter degree after 7 s
+Filtered<ProbeSampler<TempProbe>, Median<3>, Ema<1, 2>> temp_filtered(&temp_sampler);
 Keypad keypad(3, 0x20);
 volatile bool key_change_pending = false;
+volatile unsigned long key_change_time = 0;
 
 PushButton start_button(2);
 
@@ -23,10 +31,17 @@ Relay relay(12);
 StatusLED led(9, 10, 11);
 Display display(6);
 
-CyclicCaller cyclic_logic(&clk, &temp, &keypad, &display, &relay, &led);
+// sleeps between the task deadlines
+WfiIdle idle;
+
+// the hardware is fixed, bind the concrete classes so reads and writes are not virtual calls
+BasicCyclicCaller<NTP_Time, decltype(temp_filtered), Keypad, Display, Relay, StatusLED> cyclic_logic(&clk, &temp_filtered, &keypad, &display, &relay, &led);
 
 #define DEBUG 1
 
+// unattended starts at the feeding times in setup(), off by default: the schedule cannot be seen or changed at the keypad
+#define FEEDING_SCHEDULE 0
+
 void setup() {
   //Initialize serial and wait for port to open:
   Serial.begin(9600);
@@ -43,7 +58,7 @@ void setup() {
   clk.setup_clock();
   keypad.setup_keypad(keyChanged);
 
-  start_button.setup_push_button();
+  start_button.setup_push_button(startButtonChanged);
 
   display.setup();
   relay.setup();
@@ -52,25 +67,69 @@ void setup() {
   Serial.print("setup done");
 
   cyclic_logic.initializeTasks();
+  // the logic acts on a fresh sample and the relay follows in the same pass
+  cyclic_logic.setPipelined(true);
+
+#if FEEDING_SCHEDULE
+  // feeding times: 06:00 and 17:00 on work days, later and hotter on the weekend
+  StartSchedule& schedule = cyclic_logic.getSchedule();
+  schedule.addDailySlot(6 * 60, 60, 30, StartSchedule::workDays);
+  schedule.addDailySlot(17 * 60, 60, 30, StartSchedule::workDays);
+  schedule.addDailySlot(8 * 60, 70, 45, StartSchedule::weekend);
+  schedule.addDailySlot(18 * 60, 70, 45, StartSchedule::weekend);
+#endif
 
   if (DEBUG) Serial.print("initialize done");
 }
 
 void loop() {
-  Serial.print("loop");
+  // read the key right away, the fast input task processes the queued keys
   if (key_change_pending)
   {
     key_change_pending = false;
-    cyclic_logic.enableFastInputTask();
+    cyclic_logic.onKeyChanged(key_change_time);
   }
-  cyclic_logic.startTimer = start_button.is_pressed();
 
-  cyclic_logic.executeCyclicTasks();
+  // at most one probe is clocked out per pass, outside of the tasks
+  temp_sampler.poll(millis());
+
+  // send 's' over Serial to dump the task statistics, 'b' to spread the tasks by their measured run times
+  // (pipelined, the slow input, logic and output tasks are moved as one group)
+  if (DEBUG && Serial.available()) {
+    char command = Serial.read();
+    if (command == 's') {
+      cyclic_logic.printStatistics();
+      Serial.print("idle ms: ");
+      Serial.println((unsigned long)idle.getStatistics().idleTime);
+      Serial.print("max pass us: ");
+      Serial.println(cyclic_logic.getMaxPassTime());
+    }
+    else if (command == 'b') {
+      Serial.println(cyclic_logic.balanceTaskPhases() ? "tasks balanced" : "no run times measured");
+    }
+  }
+
+  // latched before sleeping, the next logic run sees a press even if the button is already released
+  cyclic_logic.setStartButton(start_button.is_pressed());
 
-  cyclic_logic.disableFastInputTask();
+  // nothing to do until the next task deadline, sleep until then or until a key or the start button is pressed
+  if (!cyclic_logic.isTaskDue(millis())) {
+    cyclic_logic.idleUntilNextDeadline(idle);
+    return;
+  }
+
+  cyclic_logic.executeCyclicTasks();
 }
 
 void keyChanged() // IRQ
 {
+  key_change_time = millis();
   key_change_pending = true;
+  idle.wake();
+}
+
+void startButtonChanged() // IRQ
+{
+  push_button_is_pressed();
+  idle.wake();
 }
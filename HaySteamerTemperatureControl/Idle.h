@@ -0,0 +1,101 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "DeadlineQueue.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+
+#include "Sandbox/millis.h"
+#endif
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+/// <summary>
+/// Number of sleeps and time spent sleeping, in milliseconds.
+/// </summary>
+struct IdleStatistics {
+    void record(unsigned long requested, unsigned long slept)
+    {
+        ++sleepCount;
+        requestedTime += requested;
+        idleTime += slept;
+        if (slept < requested) ++earlyWakeups;
+    }
+
+    void reset() { *this = IdleStatistics(); }
+
+    unsigned long sleepCount = 0;
+    unsigned long earlyWakeups = 0;        // sleeps ended by wake() before the deadline
+    unsigned long long requestedTime = 0;
+    unsigned long long idleTime = 0;
+};
+
+#ifdef ARDUINO
+/// <summary>
+/// Sleeps the RA4M1 core with WFI until the deadline or until wake() is called from an interrupt.
+/// The core wakes up on every interrupt, including the 1 ms tick of millis(), checks the deadline and the wake flag
+/// and goes back to sleep, so the CPU is halted for almost the whole idle time.
+/// </summary>
+class WfiIdle {
+public:
+    /// <summary>
+    /// Sleeps for duration_ms, returns the time actually slept.
+    /// </summary>
+    unsigned long sleepFor(unsigned long duration_ms)
+    {
+        const unsigned long start = millis();
+        const unsigned long deadline = start + duration_ms;
+        while (!wakeRequested && !isTimeReached(millis(), deadline)) {
+            __WFI();
+        }
+        wakeRequested = false;
+        unsigned long slept = millis() - start;
+        statistics.record(duration_ms, slept);
+        return slept;
+    }
+
+    // call from interrupt handlers that need the main loop right away
+    void wake() { wakeRequested = true; }
+
+    const IdleStatistics& getStatistics() const { return statistics; }
+
+private:
+    volatile bool wakeRequested = false;
+    IdleStatistics statistics;
+};
+#endif
+
+#ifdef SANDBOX_ENVIRONMENT
+/// <summary>
+/// Idle backend of the sandbox: records the requested sleeps.
+/// With the virtual sandbox clock the time jumps to the deadline, otherwise sleepFor() returns right away,
+/// busy waiting on the host would only slow down the tests.
+/// </summary>
+class SandboxIdle {
+public:
+    unsigned long sleepFor(unsigned long duration_ms)
+    {
+        unsigned long slept = 0;
+        if (!wakeRequested && SandboxClock::useVirtualTime) {
+            SandboxClock::virtualMillis += duration_ms;
+            slept = duration_ms;
+        }
+        wakeRequested = false;
+        statistics.record(duration_ms, slept);
+        return slept;
+    }
+
+    void wake() { wakeRequested = true; }
+
+    const IdleStatistics& getStatistics() const { return statistics; }
+
+private:
+    bool wakeRequested = false;
+    IdleStatistics statistics;
+};
+#endif
+
+#endif
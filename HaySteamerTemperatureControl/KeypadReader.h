@@ -1,6 +1,8 @@
 #ifndef KEYPADREADER_H
 #define KEYPADREADER_H
 
+#include "SpscQueue.h"
+
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
 
@@ -8,6 +10,7 @@
 #include "Sandbox/Sensor.h"
 #include "Sandbox/Status.h"
 #include "Sandbox/CyclicModule.h"
+#include "Sandbox/millis.h"
 
 #endif
 
@@ -22,19 +25,75 @@
 
 using keypad_input = Sensor<char>;
 
-class KeypadReader : public CyclicModule {
+// key press with the time stamp (millis) of the keypad interrupt
+struct KeyEvent {
+    char key;
+    unsigned long timeStamp;
+};
+
+/// <summary>
+/// Reads the keypad. KeypadType is the interface keypad_input or the concrete keypad class.
+/// </summary>
+template<typename KeypadType>
+class BasicKeypadReader : public CyclicModule {
 public:
     // No interval parameter needed anymore
-    KeypadReader(keypad_input* keypad)
+    BasicKeypadReader(KeypadType* keypad)
         : keypad(keypad), lastValue(0) {
     }
 
+    static constexpr size_t queueSize = 16;
+
     /// <summary>
-    /// This function updates the lastValue
-    /// It should be called periodically to keep the lastValue updated.
+    /// This function updates the lastValue and queues the key, if a key is pressed.
     /// </summary>
     void update() override {
+        readKey(millis());
+    }
+
+    /// <summary>
+    /// Reads the keypad after a key interrupt and queues the pressed key with the time stamp of the interrupt.
+    /// Call it from loop() as soon as the interrupt was signalled, not from the interrupt itself,
+    /// the keypad is read over I2C.
+    /// </summary>
+    /// <returns>false if no key is pressed or the queue is full</returns>
+    bool readKey(unsigned long timeStamp) {
         lastValue = keypad->read();
+        if (!isKey(lastValue)) {
+            return false;
+        }
+        return keyEvents.push(KeyEvent{ static_cast<char>(lastValue), timeStamp });
+    }
+
+    /// <summary>
+    /// Takes the oldest queued key press.
+    /// </summary>
+    /// <returns>false if no key press is queued</returns>
+    bool getNextEvent(KeyEvent& event) {
+        return keyEvents.pop(event);
+    }
+
+    /// <summary>
+    /// Takes the oldest queued key.
+    /// </summary>
+    /// <returns>the key or '\0' if no key press is queued</returns>
+    char getNextKey() {
+        KeyEvent event;
+        return getNextEvent(event) ? event.key : '\0';
+    }
+
+    size_t getPendingKeys() const {
+        return keyEvents.size();
+    }
+
+    // key presses lost because the queue was full
+    unsigned long getDroppedKeys() const {
+        return keyEvents.getDropped();
+    }
+
+    // the key map has 'N' for no key and 'F' for a failed read
+    static bool isKey(int value) {
+        return (value >= '0' && value <= '9') || (value >= 'A' && value <= 'D') || value == '*' || value == '#';
     }
 
     /// <summary>
@@ -46,8 +105,11 @@ public:
     }
 
 private:
-    keypad_input* keypad;
+    KeypadType* keypad;
     int lastValue;
+    SpscQueue<KeyEvent, queueSize> keyEvents;
 };
 
+using KeypadReader = BasicKeypadReader<keypad_input>;
+
 #endif
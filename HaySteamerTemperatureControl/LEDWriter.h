@@ -1,7 +1,8 @@
 #ifndef LED_WRITER_H
 #define LED_WRITER_H
 
-#include <functional>
+#include "Delegate.h"
+#include "ChangeTracking.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -15,7 +16,6 @@ using namespace std;
 #endif
 
 #ifdef ARDUINO
-#include <functional>
 // millis() is provided by the Arduino framework, no need to define it
 #include <CyclicModule.h>
 #include <Actor.h>
@@ -25,13 +25,17 @@ using namespace std;
 
 using LED = Actor<Status>;
 
-class LEDWriter : public CyclicModule {
+/// <summary>
+/// Writes the status to the LED. LedType is the interface LED or the concrete LED class.
+/// </summary>
+template<typename LedType>
+class BasicLEDWriter : public CyclicModule {
 public:
-    using ContentProvider = std::function<Status()>;
-    LEDWriter(LED* led)
+    using ContentProvider = Delegate<Status()>;
+    BasicLEDWriter(LedType* led)
         :led(led)
     { };
-    ~LEDWriter() { };
+    ~BasicLEDWriter() { };
 
     /// <summary>
     /// set (and overwrite) content provider for all lines
@@ -42,6 +46,17 @@ public:
             return;
         }
         LED_condition = provider;
+        inputs.invalidate();
+    };
+
+    /// <summary>
+    /// set the versions of the values used by the provider, update() skips writing while none of them changed.
+    /// without inputs the led is written on every update
+    /// </summary>
+    template<typename... Counters>
+    void setInputs(const Counters&... counters)
+    {
+        inputs.assign(counters...);
     };
 
     /// <summary>
@@ -53,12 +68,18 @@ public:
         if (!LED_condition) {
             return;
         }
+        if (inputs.isWatching() && !inputs.changed()) {
+            return;
+        }
         led->write(LED_condition());
     };
 
 private:
-    LED* led;
+    LedType* led;
     ContentProvider LED_condition;
+    ChangeWatch<2> inputs;
 };
 
+using LEDWriter = BasicLEDWriter<LED>;
+
 #endif
\ No newline at end of file
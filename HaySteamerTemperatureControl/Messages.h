@@ -0,0 +1,58 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Messages of the logic, shown on the second display line.
+/// </summary>
+enum class MessageId : uint8_t {
+    idle = 0,
+    ready,
+    heating,
+    holding,
+    done,
+    heatingTimeout,
+    temperatureDrop,
+    heatingStalled,
+    probesDisagree,
+    probeFailed,
+    count
+};
+
+/// <summary>
+/// Texts of the messages. The table and the literals are constant, on the board they stay in flash,
+/// the messages are passed around as pointers into it and never copied to the heap.
+/// </summary>
+constexpr const char* messageTexts[] = {
+    "idle",
+    "ready",
+    "heating",
+    "holding",
+    "done",
+    "heating timeout",
+    "temperature drop",
+    "heating stalled",
+    "probes disagree",
+    "probe failed",
+};
+static_assert(sizeof(messageTexts) / sizeof(messageTexts[0]) == static_cast<size_t>(MessageId::count),
+    "one text per message id");
+
+constexpr const char* getMessageText(MessageId id)
+{
+    return id < MessageId::count ? messageTexts[static_cast<size_t>(id)] : "";
+}
+
+/// <summary>
+/// Code of an attached fault condition, noFault if none is met.
+/// </summary>
+using FaultCode = uint8_t;
+constexpr FaultCode noFault = 0;
+
+#endif
@@ -304,21 +304,31 @@ void ParameterEditor::setCharacterProvider(CharacterProvider provider)
 void ParameterEditor::update() 
 {
 	if (!characterProvider) return; // Ensure character provider is set
-    char key = characterProvider();
+    for (int i = 0; i < maxKeysPerUpdate; ++i) {
+        char key = characterProvider();
+        if (key == '\0') return;
+        processKey(key);
+    }
+};
 
+void ParameterEditor::processKey(char key)
+{
     if (key >= 'A' && key <= 'C') {
         // Mode selection keys
         manualEditor.selectMode(key);
+        changes.markChanged();
     }
     else if (key == '*') {
         // Abort current edit
         manualEditor.abortEdit();
+        changes.markChanged();
     }
     else if (key >= '0' && key <= '9') {
         // Digit input
         if (manualEditor.processDigit(key))
             // true if editing is complete, read values
             manualEditor.commitEdit(timeHours, timeMinutes, temperature, timeSpan);
+        changes.markChanged();
     }
 };
 
@@ -364,6 +374,7 @@ void ParameterEditor::setTime(int hours, int minutes)
     if (hours >= 0 && hours <= MAX_HOURS && minutes >= 0 && minutes <= MAX_MINUTES) {
         timeHours = hours;
         timeMinutes = minutes;
+        changes.markChanged();
     }
 }
 
@@ -371,6 +382,7 @@ void ParameterEditor::setTemperature(int temp)
 {
     if (temp >= 0 && temp <= MAX_TEMPERATURE) {
         temperature = temp;
+        changes.markChanged();
     }
 }
 
@@ -378,6 +390,7 @@ void ParameterEditor::setTimeSpan(int span)
 {
     if (span >= 0 && span <= MAX_SPAN) {
         timeSpan = span;
+        changes.markChanged();
     }
 }
 
@@ -1,7 +1,8 @@
 #ifndef PARAMETER_EDITOR_H
 #define PARAMETER_EDITOR_H
 
-#include <functional>
+#include "Delegate.h"
+#include "ChangeTracking.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -132,7 +133,7 @@
     class ParameterEditor :public CyclicModule {
     public:
         // Type definition for a character provider function
-			using CharacterProvider = std::function<char()>;
+			using CharacterProvider = Delegate<char()>;
     private:
         // Parameter storage
         int timeHours;      // 0-23
@@ -148,6 +149,9 @@
 
 		CharacterProvider characterProvider;
 
+        // version of the parameters and the edit state
+        ChangeCounter changes;
+
     public:
         ParameterEditor();
 
@@ -157,11 +161,19 @@
 		/// <param name="provider">A function that provides the next character input.</param>
 		void setCharacterProvider(CharacterProvider provider);
 
+        // upper limit of keys processed in one update, keeps the run time of the fast input task bounded
+        static constexpr int maxKeysPerUpdate = 16;
+
+        /// <summary>
+        /// Processes all pending keys of the character provider, until it returns '\0'.
+        /// </summary>
+        void update () override ;
+
         /// <summary>
         /// Processes a single keyboard key input.
         /// </summary>
         /// <param name="key">The character representing the key to process.</param>
-        void update () override ;
+        void processKey(char key);
 
         /// <summary>
         /// Retrieves the display string.
@@ -169,6 +181,11 @@
         /// <returns>A String containing the display text.</returns>
         String getDisplayString();
 
+        /// <summary>
+        /// Version of the parameters and the display string, changes with every processed key and setter call.
+        /// </summary>
+        const ChangeCounter& getChangeCounter() const { return changes; }
+
         // Getters for current parameter values
         int getTimeHours() const;
         int getTimeMinutes() const;
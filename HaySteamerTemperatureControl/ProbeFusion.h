@@ -0,0 +1,138 @@
+#ifndef PROBEFUSION_H
+#define PROBEFUSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Temperature.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+// most probes one temperature reading handles, a big bale needs 4 to 6 to find its cold spots
+constexpr uint8_t maxTempProbes = 6;
+
+/// <summary>
+/// Reading of one probe with the time it was collected.
+/// </summary>
+struct ProbeSample {
+    Temperature value;
+    unsigned long timeStamp = 0;    // millis() when it was collected
+    bool valid = false;             // false until the first reading and while the probe reports an error
+};
+
+/// <summary>
+/// How the probes are fused into the one temperature the logic decides on.
+/// </summary>
+enum class FusionMode : uint8_t {
+    minimum,        // the coldest spot decides
+    median,
+    trimmedMean     // mean without the lowest and the highest probe
+};
+
+struct FusionResult {
+    Temperature value;
+    uint8_t used = 0;           // valid probes that were not rejected
+    uint8_t rejected = 0;       // valid probes that were rejected as outliers
+    bool valid = false;         // false if no probe was used
+    bool disagreement = false;  // a probe was rejected, or two probes differ by more than the outlier limit
+};
+
+/// <summary>
+/// Fuses the samples of up to MaxProbes probes. The valid samples are sorted on the stack
+/// (an insertion sort, a few compares for a handful of probes), values farther than the outlier limit
+/// from the median are rejected, the rest is fused by the mode. No heap, no float, the means keep the hundredths.
+/// In minimum mode only high values are rejected: a probe far below the others may be the cold spot the probes
+/// are there to find, it stays the minimum and is reported as a disagreement.
+/// </summary>
+template<uint8_t MaxProbes>
+class ProbeFusion {
+public:
+    static_assert(MaxProbes >= 1, "at least one probe");
+    static constexpr Temperature defaultOutlierLimit = 25_degC;
+
+    void setMode(FusionMode fusionMode) { mode = fusionMode; }
+    FusionMode getMode() const { return mode; }
+
+    // 0 turns the outlier rejection off
+    void setOutlierLimit(Temperature limit) { outlierLimit = limit < 0_degC ? 0_degC : limit; }
+    Temperature getOutlierLimit() const { return outlierLimit; }
+
+    FusionResult fuse(const ProbeSample* samples, uint8_t count) const
+    {
+        FusionResult result;
+        Temperature sorted[MaxProbes];
+        uint8_t n = 0;
+        for (uint8_t probe = 0; probe < count && probe < MaxProbes; ++probe) {
+            if (!samples[probe].valid) continue;
+            const Temperature value = samples[probe].value;
+            uint8_t i = n++;
+            while (i > 0 && sorted[i - 1] > value) {
+                sorted[i] = sorted[i - 1];
+                --i;
+            }
+            sorted[i] = value;
+        }
+        if (n == 0) {
+            return result;
+        }
+
+        // two probes cannot outvote each other, they only disagree
+        uint8_t first = 0;
+        uint8_t last = n;
+        if (outlierLimit > 0_degC) {
+            if (n >= 3) {
+                const Temperature median = medianOf(sorted, 0, n);
+                while (mode != FusionMode::minimum && first < last && median - sorted[first] > outlierLimit) ++first;
+                while (last > first && sorted[last - 1] - median > outlierLimit) --last;
+                if (first == last) {
+                    // the two middle probes are far apart, there is no majority to keep
+                    first = 0;
+                    last = n;
+                }
+                result.rejected = n - (last - first);
+            }
+            result.disagreement = result.rejected > 0 || sorted[last - 1] - sorted[first] > outlierLimit;
+        }
+        result.used = last - first;
+
+        switch (mode) {
+        case FusionMode::minimum:
+            result.value = sorted[first];
+            break;
+        case FusionMode::median:
+            result.value = medianOf(sorted, first, last);
+            break;
+        case FusionMode::trimmedMean:
+            if (last - first >= 3) {
+                ++first;
+                --last;
+            }
+            result.value = meanOf(sorted, first, last);
+            break;
+        }
+        result.valid = true;
+        return result;
+    }
+
+private:
+    static Temperature medianOf(const Temperature* sorted, uint8_t first, uint8_t last)
+    {
+        const uint8_t n = last - first;
+        const uint8_t middle = first + n / 2;
+        return (n % 2) ? sorted[middle] : meanOf(sorted, middle - 1, middle + 1);
+    }
+
+    // rounded to the nearest hundredth
+    static Temperature meanOf(const Temperature* sorted, uint8_t first, uint8_t last)
+    {
+        Temperature sum;
+        for (uint8_t i = first; i < last; ++i) sum += sorted[i];
+        return sum / (last - first);
+    }
+
+    FusionMode mode = FusionMode::minimum;
+    Temperature outlierLimit = defaultOutlierLimit;
+};
+
+#endif
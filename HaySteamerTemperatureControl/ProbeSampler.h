@@ -0,0 +1,121 @@
+#ifndef PROBESAMPLER_H
+#define PROBESAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ProbeFusion.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+
+#include "Sandbox/Sensor.h"
+#endif
+
+#ifdef ARDUINO
+#include <Sensor.h>
+#endif
+
+/// <summary>
+/// Reads probes that need time for a conversion (a MAX6675 needs 220 ms) without waiting for them.
+/// poll() collects at most one probe per call, the probes are staggered over the conversion time
+/// and every probe is collected no sooner than one conversion time after its previous collect.
+/// read() only fuses the cached samples, the temperature reader never waits for the probes.
+///
+/// Probes provides probeCount, conversionTime_ms, countsPerDegree, startConversion(probe) and
+/// bool collect(probe, int& counts), which also starts the next conversion of the probe.
+/// </summary>
+template<typename Probes>
+class ProbeSampler final : public Sensor<Temperature> {
+public:
+    static constexpr uint8_t probeCount = Probes::probeCount;
+    static constexpr unsigned long conversionTime = Probes::conversionTime_ms;
+    static constexpr unsigned long stagger = conversionTime / probeCount;
+    static_assert(probeCount >= 1 && probeCount <= maxTempProbes, "1 to maxTempProbes probes");
+
+    explicit ProbeSampler(Probes* probes)
+        : probes(probes)
+    { }
+
+    /// <summary>
+    /// Starts the conversions, the first probe is due one conversion time later, every further one a stagger after it.
+    /// Called by the first poll() if not called before.
+    /// </summary>
+    void begin(unsigned long now)
+    {
+        for (uint8_t probe = 0; probe < probeCount; ++probe) {
+            probes->startConversion(probe);
+            dueAt[probe] = now + conversionTime + probe * stagger;
+        }
+        next = 0;
+        started = true;
+    }
+
+    /// <summary>
+    /// Collects the next probe if its conversion is done. Call it often, e.g. every pass of the main loop.
+    /// </summary>
+    /// <returns>true if a sample was collected</returns>
+    bool poll(unsigned long now)
+    {
+        if (!started) {
+            begin(now);
+        }
+        if (static_cast<long>(now - dueAt[next]) < 0) {
+            return false;
+        }
+        ProbeSample& sample = samples[next];
+        int counts = 0;
+        sample.valid = probes->collect(next, counts);
+        if (sample.valid) {
+            sample.value = Temperature::fromCounts(counts, Probes::countsPerDegree);
+        }
+        sample.timeStamp = now;
+        lastCollect = now;
+        // keeps the stagger, a late poll moves the whole round
+        dueAt[next] = now + conversionTime;
+        next = (next + 1) % probeCount;
+        if (static_cast<long>(dueAt[next] - (now + stagger)) < 0) {
+            dueAt[next] = now + stagger;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Fuses the cached samples, by default the coldest spot decides. No probe is accessed.
+    /// Keeps the last value if no probe delivers a valid sample.
+    /// </summary>
+    Temperature read() override
+    {
+        fused = fusion.fuse(samples, probeCount);
+        if (fused.valid) {
+            lastValue = fused.value;
+        }
+        return lastValue;
+    }
+
+    uint8_t getProbeCount() const { return probeCount; }
+    const ProbeSample& getSample(uint8_t probe) const { return samples[probe]; }
+
+    // mode and outlier limit of the fusion
+    ProbeFusion<probeCount>& getFusion() { return fusion; }
+    // result of the last read()
+    const FusionResult& getFusionResult() const { return fused; }
+
+    // millis() of the latest collect
+    unsigned long getSampleTime() const { return lastCollect; }
+
+    // a probe is collected about once per conversion time
+    unsigned long getConversionTime() const { return conversionTime; }
+
+private:
+    Probes* probes;
+    ProbeSample samples[probeCount] = {};
+    ProbeFusion<probeCount> fusion;
+    FusionResult fused;
+    unsigned long dueAt[probeCount] = {};
+    unsigned long lastCollect = 0;
+    uint8_t next = 0;
+    Temperature lastValue;
+    bool started = false;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef PROCESSIMAGE_H
+#define PROCESSIMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "Temperature.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Snapshot of all inputs of the logic, taken once at the start of a logic run like the process image of a PLC.
+/// Every decision of the run sees the same values, no matter how long the run takes or what the interrupts do meanwhile.
+/// </summary>
+struct ProcessImage {
+    static constexpr size_t maxProbes = 6;
+
+    // the temperature the logic decides on, fused from the probes
+    Temperature getTemperature() const { return temperature; }
+
+    // clock
+    unsigned long timeStamp = 0;            // millis() when the image was captured
+    unsigned long timeOfDayInMinutes = 0;
+    unsigned long minuteOfWeek = 0;         // 0 is monday 00:00
+
+    // temperatures, fused and per probe
+    Temperature temperature;
+    Temperature temperatures[maxProbes] = {};
+    uint8_t probeCount = 1;
+    uint8_t failedProbes = 0;   // bit per probe without a valid, recent sample, see BasicTempReader::getFailedProbes()
+    bool probesDisagree = false;
+
+    // operator inputs
+    char lastKey = '\0';
+    bool startButton = false;   // pressed now or pressed at least once since the last logic run
+    bool scheduledStart = false; // a run started by the weekly schedule is going on
+
+    // parameters, of the schedule slot during a scheduled run
+    unsigned long startTimeInMinutes = 0;
+    Temperature minimumTemperature = 60_degC;
+    unsigned long waitTime = 30;
+};
+
+/// <summary>
+/// Inputs written by interrupt handlers, copied into the process image as a whole.
+/// </summary>
+struct IsrInputs {
+    bool startButton = false;
+    uint16_t startPresses = 0;  // latches presses shorter than a logic cycle
+};
+
+/// <summary>
+/// Hands a value from one writer (e.g. an interrupt) to one reader without disabling interrupts.
+/// The writer fills the buffer the reader is not using and publishes it with the version,
+/// the reader copies the published buffer and retries if the writer published twice during the copy.
+/// </summary>
+template<typename T>
+class DoubleBuffer {
+public:
+    // writer side
+    void write(const T& value)
+    {
+        const unsigned next = version.load(std::memory_order_relaxed) + 1;
+        buffers[next & 1] = value;
+        version.store(next, std::memory_order_release);
+    }
+
+    // writer side: the last written value, only the writer changes it
+    const T& lastWritten() const
+    {
+        return buffers[version.load(std::memory_order_relaxed) & 1];
+    }
+
+    // reader side: consistent copy of the last written value
+    T read() const
+    {
+        for (;;) {
+            const unsigned current = version.load(std::memory_order_acquire);
+            T copy = buffers[current & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == current) {
+                return copy;
+            }
+        }
+    }
+
+private:
+    T buffers[2] = {};
+    std::atomic<unsigned> version{ 0 };
+};
+
+#endif
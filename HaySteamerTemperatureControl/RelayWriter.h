@@ -1,7 +1,8 @@
 #ifndef RELAY_WRITER_H
 #define RELAY_WRITER_H
 
-#include <functional>
+#include "Delegate.h"
+#include "ChangeTracking.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
@@ -15,7 +16,6 @@ using namespace std;
 
 #ifdef ARDUINO
 #include <string>
-#include <functional>
 // millis() is provided by the Arduino framework, no need to define it
 #include <CyclicModule.h>
 #include <Actor.h>
@@ -24,13 +24,17 @@ using namespace std;
 
 using relay_output = Actor<byte>;
 
-class RelayWriter : public CyclicModule {
+/// <summary>
+/// Writes the relay state. RelayType is the interface relay_output or the concrete relay class.
+/// </summary>
+template<typename RelayType>
+class BasicRelayWriter : public CyclicModule {
 public:
-    using ContentProvider = std::function<byte()>;
-    RelayWriter(relay_output* relay)
+    using ContentProvider = Delegate<byte()>;
+    BasicRelayWriter(RelayType* relay)
 		: relay(relay)
     { };
-    ~RelayWriter() {};
+    ~BasicRelayWriter() {};
 
     /// <summary>
     /// set (and overwrite) content provider for all lines
@@ -41,6 +45,17 @@ public:
             return;
         }
         relay_condition = provider;
+        inputs.invalidate();
+    };
+
+    /// <summary>
+    /// set the versions of the values used by the provider, update() skips writing while none of them changed.
+    /// without inputs the relay is written on every update
+    /// </summary>
+    template<typename... Counters>
+    void setInputs(const Counters&... counters)
+    {
+        inputs.assign(counters...);
     };
 
     /// <summary>
@@ -52,15 +67,26 @@ public:
         if (!relay_condition) {
             return;
         }
+        if (inputs.isWatching() && !inputs.changed()) {
+            return;
+        }
         currentState = relay_condition();
 
         relay->write(currentState);
+        ++writeCount;
     };
 
+    // number of writes to the relay
+    unsigned long getWriteCount() const { return writeCount; };
+
 private:
-    relay_output* relay;
+    RelayType* relay;
     ContentProvider relay_condition;
+    ChangeWatch<2> inputs;
     byte currentState = byte{ 0 };
+    unsigned long writeCount = 0;
 };
 
+using RelayWriter = BasicRelayWriter<relay_output>;
+
 #endif
\ No newline at end of file
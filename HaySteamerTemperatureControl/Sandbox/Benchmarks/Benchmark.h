@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Minimal benchmark harness for the sandbox.
+// Benchmarks register themselves with BENCHMARK(name) and are run by the Benchmarks executable,
+// they are not part of the unit tests because the results depend on the host.
+struct BenchmarkRegistry {
+    using Function = void(*)();
+    struct Entry {
+        const char* name;
+        Function function;
+    };
+
+    static std::vector<Entry>& entries()
+    {
+        static std::vector<Entry> registered;
+        return registered;
+    }
+};
+
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, BenchmarkRegistry::Function function)
+    {
+        BenchmarkRegistry::entries().push_back({ name, function });
+    }
+};
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static BenchmarkRegistrar name##Registrar(#name, name); \
+    static void name()
+
+// keeps the compiler from optimizing away a result: the value escapes to memory the compiler cannot see through
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    // storing the address in a volatile pointer makes the compiler materialize the value
+    static const T* volatile sink;
+    sink = &value;
+#endif
+}
+
+// runs body iterations times and prints the mean time per iteration
+template<typename Body>
+inline double measure(const char* label, unsigned long iterations, Body body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; ++i) {
+        body();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double perIteration = elapsed / static_cast<double>(iterations);
+    std::printf("  %-40s %8.2f ns\n", label, perIteration);
+    return perIteration;
+}
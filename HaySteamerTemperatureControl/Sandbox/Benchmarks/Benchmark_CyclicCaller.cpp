@@ -0,0 +1,39 @@
+#include "Benchmark.h"
+#include "../../TaskScheduler.h"
+#include "../Simulator.h"
+#include "../SimulatedPlant.h"
+
+namespace {
+    using ConcreteCyclicCaller = BasicCyclicCaller<SimulatedClock, SimulatedHayBale, SimulatedKeypad,
+        SimulatedDisplay, SimulatedRelay, SimulatedLED>;
+
+    // host time per scheduler pass, one hour of virtual time with all modules running
+    template<typename Caller>
+    void measurePass(const char* label)
+    {
+        SimulatedClock clock{ 0 };
+        SimulatedHayBale bale;
+        SimulatedKeypad keypad;
+        SimulatedDisplay display;
+        SimulatedRelay relay{ bale };
+        SimulatedLED led;
+        Caller caller{ &clock, &bale, &keypad, &display, &relay, &led };
+        keypad.setInterruptHandler([&] { caller.onKeyChanged(millis()); });
+        Simulator<Caller> sim(caller);
+
+        auto start = std::chrono::steady_clock::now();
+        sim.runFor(3600000);
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  %-40s %8.2f ns per pass (%lu passes)\n", label,
+            elapsed / static_cast<double>(sim.getPassCount()), sim.getPassCount());
+    }
+}
+
+// interface bound hardware (CyclicCaller) against compile-time bound hardware (BasicCyclicCaller)
+BENCHMARK(CyclicCallerPass)
+{
+    measurePass<CyclicCaller>("CyclicCaller (virtual read/write)");
+    measurePass<ConcreteCyclicCaller>("BasicCyclicCaller (concrete types)");
+    std::printf("  sizeof CyclicCaller %zu, sizeof BasicCyclicCaller %zu\n",
+        sizeof(CyclicCaller), sizeof(ConcreteCyclicCaller));
+}
@@ -0,0 +1,32 @@
+#include "Benchmark.h"
+#include "../../Delegate.h"
+
+#include <functional>
+
+namespace {
+    struct Source {
+        int value = 42;
+        int read() const { return value; }
+    };
+
+    const unsigned long iterations = 10000000;
+}
+
+// call cost of a provider bound to a member function, as wired in CyclicCaller::initializeTasks()
+BENCHMARK(DelegateCall)
+{
+    Source source;
+    std::function<int()> function = [&source] { return source.read(); };
+    Delegate<int()> delegate = [&source] { return source.read(); };
+
+    // hide the callables from the optimizer, like the providers stored in the modules
+    std::function<int()>* volatile functionPointer = &function;
+    Delegate<int()>* volatile delegatePointer = &delegate;
+
+    measure("direct call", iterations, [&] { doNotOptimize(source.read()); });
+    measure("std::function", iterations, [&] { doNotOptimize((*functionPointer)()); });
+    measure("Delegate", iterations, [&] { doNotOptimize((*delegatePointer)()); });
+
+    std::printf("  sizeof std::function<int()> %zu, sizeof Delegate<int()> %zu\n",
+        sizeof(std::function<int()>), sizeof(Delegate<int()>));
+}
@@ -0,0 +1,38 @@
+#include "Benchmark.h"
+#include "../../SensorFilters.h"
+
+namespace {
+    // noisy ramp, the value is hidden from the optimizer
+    class NoisySensor : public Sensor<int> {
+    public:
+        int read() override {
+            step = step * 1103515245u + 12345u;
+            return 60 + static_cast<int>((step >> 16) % 3);
+        }
+    private:
+        volatile unsigned seedStep = 1;
+        unsigned step = seedStep;
+    };
+
+    const unsigned long iterations = 10000000;
+
+    template<typename FilteredSensor>
+    void measureFiltered(const char* label)
+    {
+        NoisySensor sensor;
+        FilteredSensor filtered(&sensor);
+        measure(label, iterations, [&] { doNotOptimize(filtered.read()); });
+    }
+}
+
+// one reading per iteration, the unfiltered sensor is the baseline
+BENCHMARK(SensorFilterStages)
+{
+    measureFiltered<Filtered<NoisySensor>>("no stage");
+    measureFiltered<Filtered<NoisySensor, Median<5>>>("Median<5>");
+    measureFiltered<Filtered<NoisySensor, Ema<1, 4>>>("Ema<1, 4>");
+    measureFiltered<Filtered<NoisySensor, RateLimit<2>>>("RateLimit<2>");
+    measureFiltered<Filtered<NoisySensor, Deadband<1>>>("Deadband<1>");
+    measureFiltered<Filtered<NoisySensor, Median<5>, Ema<1, 4>>>("Median<5>, Ema<1, 4>");
+    measureFiltered<Filtered<NoisySensor, Median<5>, Ema<1, 4>, RateLimit<2>, Deadband<1>>>("all four");
+}
@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include "../../StateMachine.h"
+
+namespace {
+    // the comparison chain HaySteamerStateMachine used before the transition table
+    bool isTransitionAllowedByChain(Status oldStatus, Status newStatus)
+    {
+        if (newStatus == Status::error) return oldStatus != Status::error;
+        if (oldStatus == Status::error) return newStatus == Status::idle;
+        return (oldStatus == Status::idle    && newStatus == Status::ready)   ||
+               (oldStatus == Status::idle    && newStatus == Status::heating) ||
+               (oldStatus == Status::ready   && newStatus == Status::heating) ||
+               (oldStatus == Status::heating && newStatus == Status::holding) ||
+               (oldStatus == Status::holding && newStatus == Status::done)    ||
+               (oldStatus == Status::done    && newStatus == Status::idle);
+    }
+
+    const unsigned long iterations = 10000000;
+    const size_t statusCount = HaySteamerStateMachine::statusCount;
+}
+
+// lookup of all edges, the states are hidden from the optimizer
+BENCHMARK(StateMachineTransitionLookup)
+{
+    volatile size_t seed = 0;
+    size_t edge = seed;
+    measure("comparison chain", iterations, [&] {
+        edge = (edge + 1) % (statusCount * statusCount);
+        doNotOptimize(isTransitionAllowedByChain(static_cast<Status>(edge / statusCount), static_cast<Status>(edge % statusCount)));
+    });
+    edge = seed;
+    measure("transition table", iterations, [&] {
+        edge = (edge + 1) % (statusCount * statusCount);
+        doNotOptimize(HaySteamerStateMachine::isTransitionAllowed(static_cast<Status>(edge / statusCount), static_cast<Status>(edge % statusCount)));
+    });
+
+    // one process cycle per iteration, with counters and an entry hook
+    HaySteamerStateMachine sm;
+    unsigned long entries = 0;
+    sm.setOnEntry(Status::heating, [&entries](Status) { ++entries; });
+    measure("changeStatus, process cycle of 4", iterations / 4, [&] {
+        sm.changeStatus(Status::heating);
+        sm.changeStatus(Status::holding);
+        sm.changeStatus(Status::done);
+        sm.changeStatus(Status::idle);
+    });
+    doNotOptimize(entries);
+}
@@ -0,0 +1,10 @@
+#include "Benchmark.h"
+
+int main()
+{
+    for (const auto& entry : BenchmarkRegistry::entries()) {
+        std::printf("%s\n", entry.name);
+        entry.function();
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "../../ChangeTracking.h"
+
+TEST(ChangeCounterTest, PublishOnlyCountsChangedValues) {
+    ChangeCounter counter;
+    int value = 0;
+    counter.publish(value, 0);
+    EXPECT_EQ(counter.getVersion(), 0u);
+    counter.publish(value, 5);
+    EXPECT_EQ(value, 5);
+    EXPECT_EQ(counter.getVersion(), 1u);
+    counter.publish(value, 5);
+    EXPECT_EQ(counter.getVersion(), 1u);
+    counter.markChanged();
+    EXPECT_EQ(counter.getVersion(), 2u);
+}
+
+TEST(ChangeWatchTest, WithoutInputsNothingIsWatched) {
+    ChangeWatch<2> watch;
+    EXPECT_FALSE(watch.isWatching());
+}
+
+TEST(ChangeWatchTest, FirstCheckAfterAssignReportsChange) {
+    ChangeCounter a;
+    ChangeWatch<2> watch;
+    watch.assign(a);
+    EXPECT_TRUE(watch.isWatching());
+    EXPECT_TRUE(watch.changed());
+    EXPECT_FALSE(watch.changed());
+}
+
+TEST(ChangeWatchTest, ReportsChangeOfAnyInputOnce) {
+    ChangeCounter a, b;
+    ChangeWatch<2> watch;
+    watch.assign(a, b);
+    watch.changed();
+
+    b.markChanged();
+    EXPECT_TRUE(watch.changed());
+    EXPECT_FALSE(watch.changed());
+
+    a.markChanged();
+    a.markChanged();
+    EXPECT_TRUE(watch.changed());
+    EXPECT_FALSE(watch.changed());
+}
+
+TEST(ChangeWatchTest, InvalidateForcesChange) {
+    ChangeCounter a;
+    ChangeWatch<1> watch;
+    watch.assign(a);
+    watch.changed();
+    watch.invalidate();
+    EXPECT_TRUE(watch.changed());
+}
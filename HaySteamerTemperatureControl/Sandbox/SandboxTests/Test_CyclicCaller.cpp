@@ -1,9 +1,3 @@
-#define USE_TEST_MILLIS
-namespace {
-    unsigned long fakeMillis = 0;
-    unsigned long millis() { return fakeMillis; }
-}
-
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "../TaskScheduler.h"
@@ -12,6 +6,11 @@ namespace {
 #include "../Status.h"
 #include "../millis.h"
 
+namespace {
+    // the tests drive the virtual sandbox clock by hand
+    unsigned long& fakeMillis = SandboxClock::virtualMillis;
+}
+
 // --- Fake Sensor Streams for Process Logic ---
 
 class FakeClock : public Sensor<time_t> {
@@ -23,13 +22,15 @@ private:
     unsigned long timeStamp;
 };
 
-class FakeTemp : public Sensor<int> {
+class FakeTemp : public Sensor<Temperature> {
 public:
-    FakeTemp() : temp(20) {}
-    void set(int t) { temp = t; }
-    int read() override { return temp; }
+    FakeTemp() : temp(20_degC) {}
+    void set(int degrees) { temp = Temperature::fromCelsius(degrees); }
+    void setReadDuration(unsigned long duration_ms) { readDuration = duration_ms; }
+    Temperature read() override { fakeMillis += readDuration; return temp; }
 private:
-    int temp;
+    Temperature temp;
+    unsigned long readDuration = 0;
 };
 
 class FakeKeypad : public Sensor<char> {
@@ -70,8 +71,9 @@ protected:
     std::unique_ptr<CyclicCaller> caller;
 
     void SetUp() override {
-        caller = std::make_unique<CyclicCaller>(&clock, &temp, &keypad, &display, &relay, &led);
+        SandboxClock::useVirtualTime = true;
         fakeMillis = 0;
+        caller = std::make_unique<CyclicCaller>(&clock, &temp, &keypad, &display, &relay, &led);
 
         ON_CALL(display, write(testing::_))
             .WillByDefault(
@@ -81,16 +83,20 @@ protected:
                     }
                 });
     }
+
+    void TearDown() override {
+        SandboxClock::useVirtualTime = false;
+    }
 };
 
 // --- Helper: Drive Process Through All States ---
 
 void driveProcess(CyclicCaller& caller, FakeClock& clock, FakeTemp& temp) {
-    // 1. Start in idle, trigger ready via startTimer
-    caller.startTimer = true;
+    // 1. Start in idle, trigger ready via the start button
+    caller.setStartButton(true);
     fakeMillis += 2000;
     caller.executeCyclicTasks();
-    caller.startTimer = false;
+    caller.setStartButton(false);
 
     // 2. Now in ready, trigger heating via runTimer (timerCondition)
     // Simulate startConditions false, timerCondition true
@@ -130,7 +136,7 @@ TEST_F(CyclicCallerProcessTest, ExecuteCyclicTasksRunsScheduledTasks) {
 
 TEST_F(CyclicCallerProcessTest, StartTimerFlagAffectsLogic) {
     caller->initializeTasks();
-    caller->startTimer = true;
+    caller->setStartButton(true);
     EXPECT_NO_THROW(caller->executeCyclicTasks());
 }
 
@@ -161,14 +167,14 @@ TEST_F(CyclicCallerProcessTest, StateTransitionsAreCorrect) {
 
 
     // 1. idle -> ready  
-    caller->startTimer = true;  
+    caller->setStartButton(true);  
     fakeMillis += 2000;  
     
     caller->executeCyclicTasks();
     EXPECT_EQ(lastDisplay[1], "ready");
 
     // 2. ready -> heating  
-    caller->startTimer = false;  
+    caller->setStartButton(false);  
     clock.set(951827696 + 60); // Simulate timerCondition true  
     fakeMillis += 2000;  
     caller->executeCyclicTasks();  
@@ -191,4 +197,392 @@ TEST_F(CyclicCallerProcessTest, StateTransitionsAreCorrect) {
     fakeMillis += 60000;  
     caller->executeCyclicTasks();  
     EXPECT_EQ(lastDisplay[1], "idle");
-}
\ No newline at end of file
+}
+// --- Deadline queue ---
+
+TEST_F(CyclicCallerProcessTest, NextDeadlineIsEarliestTaskRun) {
+    fakeMillis = 5000;
+    caller->initializeTasks();
+    // fast input task (100 ms) is the first one due
+    EXPECT_EQ(caller->nextDeadline(), 5100u);
+    EXPECT_FALSE(caller->isTaskDue(5099));
+    EXPECT_TRUE(caller->isTaskDue(5100));
+
+    fakeMillis = 5100;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->nextDeadline(), 5200u);
+}
+
+TEST_F(CyclicCallerProcessTest, NothingRunsBeforeNextDeadline) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_CALL(display, write(testing::_)).Times(0);
+    EXPECT_CALL(relay, write(testing::_)).Times(0);
+    EXPECT_CALL(led, write(testing::_)).Times(0);
+    fakeMillis = 999;
+    caller->executeCyclicTasks();
+}
+
+TEST_F(CyclicCallerProcessTest, OutputTaskRunsOnItsDeadline) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_CALL(display, write(testing::_)).Times(1);
+    EXPECT_CALL(relay, write(testing::_)).Times(1);
+    EXPECT_CALL(led, write(testing::_)).Times(1);
+    for (fakeMillis = 100; fakeMillis <= 1000; fakeMillis += 100) {
+        caller->executeCyclicTasks();
+    }
+    EXPECT_EQ(caller->nextDeadline(), 1100u);
+}
+
+TEST_F(CyclicCallerProcessTest, OutputsAreOnlyWrittenWhenStatusChanges) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_CALL(relay, write(testing::_)).Times(1);
+    EXPECT_CALL(led, write(Status::idle)).Times(1);
+    for (fakeMillis = 100; fakeMillis <= 5000; fakeMillis += 100) {
+        caller->executeCyclicTasks();
+    }
+    testing::Mock::VerifyAndClearExpectations(&relay);
+    testing::Mock::VerifyAndClearExpectations(&led);
+
+    // idle -> ready with the next logic run at 6000, written by the output task at 6000
+    EXPECT_CALL(relay, write(testing::_)).Times(1);
+    EXPECT_CALL(led, write(Status::ready)).Times(1);
+    caller->setStartButton(true);
+    for (; fakeMillis <= 10000; fakeMillis += 100) {
+        caller->executeCyclicTasks();
+    }
+}
+
+// --- Task statistics ---
+
+TEST_F(CyclicCallerProcessTest, StatisticsRecordRunTimeLatenessAndMissedCycles) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    temp.setReadDuration(3);
+
+    // slow input task runs on time and takes 3 ms
+    fakeMillis = 1000;
+    caller->executeCyclicTasks();
+    const TaskStatistics& slowInput = caller->getTaskStatistics(0);
+    EXPECT_EQ(slowInput.runCount, 1u);
+    EXPECT_EQ(slowInput.minRunTime, 3000u);
+    EXPECT_EQ(slowInput.maxRunTime, 3000u);
+    EXPECT_EQ(slowInput.latenessHistogram[0], 1u);
+    EXPECT_EQ(slowInput.missedCycles, 0u);
+
+    // next run was due at 2000, runs at 4050: two cycles missed
+    fakeMillis = 4050;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(slowInput.runCount, 2u);
+    EXPECT_EQ(slowInput.getMeanRunTime(), 3000u);
+    EXPECT_EQ(slowInput.latenessHistogram[TaskStatistics::latenessBuckets - 1], 1u);
+    EXPECT_EQ(slowInput.missedCycles, 2u);
+}
+
+TEST_F(CyclicCallerProcessTest, CpuLoadIsBusyShareOfObservedTime) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    temp.setReadDuration(500);
+
+    fakeMillis = 1000;
+    caller->executeCyclicTasks(); // busy until 1500
+    fakeMillis = 2000;
+    caller->executeCyclicTasks(); // busy until 2500
+    // 1000 ms busy in 2500 ms
+    EXPECT_EQ(caller->getCpuLoadPercent(), 40u);
+
+    caller->resetStatistics();
+    EXPECT_EQ(caller->getCpuLoadPercent(), 0u);
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 0u);
+}
+
+TEST_F(CyclicCallerProcessTest, StatisticsStringNamesTask) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    fakeMillis = 100;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->getTaskCount(), 4u);
+    EXPECT_STREQ(caller->getTaskName(1), "fast input");
+    EXPECT_EQ(caller->getStatisticsString(1),
+        "fast input: runs 1, us min/mean/max 0/0/0, missed 0, late ms 1 0 0 0 0 0 0 0");
+    EXPECT_EQ(caller->getStatisticsString(0).rfind("slow input: runs 0,", 0), 0u);
+}
+
+// --- Timer wraparound ---
+
+TEST_F(CyclicCallerProcessTest, TasksKeepRunningAcrossTimerWraparound) {
+    fakeMillis = ~0UL - 1500; // 1.5 s before millis() wraps
+    caller->initializeTasks();
+    for (int i = 0; i < 30; ++i) {
+        fakeMillis += 100;
+        caller->executeCyclicTasks();
+    }
+    EXPECT_EQ(caller->getTaskStatistics(3).runCount, 3u);
+    EXPECT_EQ(caller->getTaskStatistics(1).runCount, 30u);
+    EXPECT_EQ(caller->getTaskStatistics(1).missedCycles, 0u);
+}
+
+// --- Idle between deadlines ---
+
+TEST_F(CyclicCallerProcessTest, TimeToNextDeadline) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_EQ(caller->getTimeToNextDeadline(0), 100u);
+    EXPECT_EQ(caller->getTimeToNextDeadline(60), 40u);
+    EXPECT_EQ(caller->getTimeToNextDeadline(100), 0u);
+    EXPECT_EQ(caller->getTimeToNextDeadline(150), 0u);
+}
+
+TEST_F(CyclicCallerProcessTest, IdleSleepsUntilNextDeadline) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    SandboxIdle idle;
+    EXPECT_EQ(caller->idleUntilNextDeadline(idle), 100u);
+    EXPECT_EQ(fakeMillis, 100u);
+    EXPECT_TRUE(caller->isTaskDue(fakeMillis));
+    // nothing to sleep while a task is due
+    EXPECT_EQ(caller->idleUntilNextDeadline(idle), 0u);
+    EXPECT_EQ(idle.getStatistics().sleepCount, 1u);
+}
+
+TEST_F(CyclicCallerProcessTest, WakeEndsIdleEarly) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    SandboxIdle idle;
+    idle.wake();
+    EXPECT_EQ(caller->idleUntilNextDeadline(idle), 0u);
+    EXPECT_EQ(idle.getStatistics().earlyWakeups, 1u);
+    EXPECT_EQ(fakeMillis, 0u);
+}
+
+// the main loop of the sketch with the sandbox idle backend, the cpu sleeps for almost all of the time
+TEST_F(CyclicCallerProcessTest, MainLoopIsIdleMostOfTheTime) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    SandboxIdle idle;
+    unsigned long passes = 0;
+    while (fakeMillis < 60000) {
+        if (!caller->isTaskDue(millis())) {
+            caller->idleUntilNextDeadline(idle);
+            continue;
+        }
+        caller->executeCyclicTasks();
+        ++passes;
+    }
+    // passes at 100, 200, ... 59900 ms, the loop ends when the clock reaches 60000 ms
+    EXPECT_EQ(passes, 599u);
+    EXPECT_EQ(idle.getStatistics().sleepCount, 600u);
+    EXPECT_EQ(idle.getStatistics().idleTime, 60000u);
+}
+
+// --- Phase offsets ---
+
+TEST_F(CyclicCallerProcessTest, PhaseOffsetDelaysTaskRuns) {
+    caller->setPhaseOffset(0, 300);
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_EQ(caller->getPhaseOffset(0), 300u);
+    for (fakeMillis = 100; fakeMillis <= 1200; fakeMillis += 100) {
+        caller->executeCyclicTasks();
+    }
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 0u);
+    fakeMillis = 1300;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 1u);
+
+    // the pending run is only ever moved forward, moving the phase back from 300 to 100 skips to 3100
+    caller->setPhaseOffset(0, 100);
+    for (fakeMillis = 1400; fakeMillis <= 3000; fakeMillis += 100) {
+        caller->executeCyclicTasks();
+    }
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 1u);
+    fakeMillis = 3100;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 2u);
+    EXPECT_EQ(caller->getPhaseOffset(0), 100u);
+    // offsets are taken modulo the interval
+    caller->setPhaseOffset(0, 1200);
+    EXPECT_EQ(caller->getPhaseOffset(0), 200u);
+}
+
+TEST_F(CyclicCallerProcessTest, BalancingNeedsMeasuredRunTimes) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    EXPECT_FALSE(caller->balanceTaskPhases());
+}
+
+// slow input (30 ms) and display (20 ms) run in the same pass until the balancing moves them apart
+TEST_F(CyclicCallerProcessTest, BalancingSpreadsExpensiveTasks) {
+    ON_CALL(display, write(testing::_)).WillByDefault([](String*) { fakeMillis += 20; });
+    EXPECT_CALL(display, write(testing::_)).Times(testing::AnyNumber());
+    temp.setReadDuration(30);
+    fakeMillis = 0;
+    caller->initializeTasks();
+    auto run = [&](unsigned long until) {
+        for (unsigned long t = fakeMillis / 100 * 100 + 100; t <= until; t += 100) {
+            fakeMillis = t;
+            clock.set(t / 1000 * 60); // new minute every second, the display is written on every output run
+            caller->executeCyclicTasks();
+        }
+    };
+    run(4000);
+    EXPECT_EQ(caller->getMaxPassTime(), 50000u);
+
+    EXPECT_TRUE(caller->balanceTaskPhases());
+    EXPECT_EQ(caller->getPhaseOffset(0), 0u);    // most expensive task stays
+    EXPECT_EQ(caller->getPhaseOffset(3), 100u);  // output in the next slot
+    EXPECT_EQ(caller->getPhaseOffset(2), 200u);  // logic in an empty slot
+    EXPECT_EQ(caller->getPhaseOffset(1), 0u);    // fast input runs in every slot anyway
+
+    caller->resetStatistics();
+    run(10000);
+    EXPECT_EQ(caller->getMaxPassTime(), 30000u);
+    EXPECT_EQ(caller->getTaskStatistics(3).missedCycles, 0u);
+}
+
+// --- Pipelined rate group ---
+
+class CyclicCallerPipelineTest : public CyclicCallerProcessTest {
+protected:
+    // staggered like after balancing: slow input at 0, output at 100, logic at 200 ms
+    void SetUp() override {
+        CyclicCallerProcessTest::SetUp();
+        fakeMillis = 0;
+        caller->initializeTasks();
+        caller->setPhaseOffset(3, 100);
+        caller->setPhaseOffset(2, 200);
+        temp.setReadDuration(5);
+    }
+
+    void runUntil(unsigned long until) {
+        for (unsigned long t = fakeMillis / 100 * 100 + 100; t <= until; t += 100) {
+            fakeMillis = t;
+            caller->executeCyclicTasks();
+        }
+    }
+
+    // idle -> ready -> heating, then the temperature reaches the holding threshold
+    void heatUntilHolding() {
+        clock.set(951827696);
+        caller->setStartButton(true);
+        runUntil(3500);
+        ASSERT_EQ(lastDisplay[1], "ready");
+        caller->setStartButton(false);
+        clock.set(951827696 + 60);
+        runUntil(5500);
+        ASSERT_EQ(lastDisplay[1], "heating");
+        temp.set(60);
+        runUntil(9500);
+        ASSERT_EQ(lastDisplay[1], "holding");
+    }
+};
+
+TEST_F(CyclicCallerPipelineTest, StaggeredTasksDelayTheRelay) {
+    heatUntilHolding();
+    // sample at 6000, logic at 6200, relay written at 7100
+    const LatencyStatistics& latency = caller->getActuationLatency();
+    ASSERT_EQ(latency.count, 3u); // ready, heating and holding
+    EXPECT_EQ(latency.max, 1100u);
+}
+
+TEST_F(CyclicCallerPipelineTest, PipelineWritesTheRelayInTheSamplingPass) {
+    caller->setPipelined(true);
+    EXPECT_TRUE(caller->isPipelined());
+    EXPECT_EQ(caller->getPhaseOffset(0), 200u);
+    EXPECT_EQ(caller->getPhaseOffset(3), 200u);
+    heatUntilHolding();
+    const LatencyStatistics& latency = caller->getActuationLatency();
+    ASSERT_EQ(latency.count, 3u);
+    EXPECT_EQ(latency.max, 5u); // just the temperature read
+}
+
+TEST_F(CyclicCallerPipelineTest, LogicRunPullsInputsAndOutputsIntoItsPass) {
+    caller->setPipelined(true);
+    // the slow input is moved off the logic phase, it runs at 1500, 2500, ... and with every logic run
+    caller->setPhaseOffset(0, 500);
+    runUntil(2200);
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 1u + 1u);
+    EXPECT_EQ(caller->getTaskStatistics(2).runCount, 1u);
+    // its own deadline is not moved by the extra run
+    runUntil(2500);
+    EXPECT_EQ(caller->getTaskStatistics(0).runCount, 3u);
+}
+
+// balancing moves the pipeline as one group, it does not stagger the slow input and output against the logic
+TEST_F(CyclicCallerPipelineTest, BalancingKeepsThePipelineTogether) {
+    caller->setPipelined(true);
+    runUntil(4000);
+    EXPECT_TRUE(caller->balanceTaskPhases());
+    EXPECT_EQ(caller->getPhaseOffset(0), caller->getPhaseOffset(2) % 1000);
+    EXPECT_EQ(caller->getPhaseOffset(3), caller->getPhaseOffset(2) % 1000);
+}
+
+TEST_F(CyclicCallerPipelineTest, MovingTheLogicMovesThePipeline) {
+    caller->setPipelined(true);
+    caller->setPhaseOffset(2, 700);
+    EXPECT_EQ(caller->getPhaseOffset(0), 700u);
+    EXPECT_EQ(caller->getPhaseOffset(3), 700u);
+}
+
+// --- Process image ---
+
+TEST_F(CyclicCallerProcessTest, ShortStartPressIsLatchedUntilTheLogicRuns) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    fakeMillis = 1000;
+    caller->executeCyclicTasks();
+    // pressed and released between two logic runs
+    caller->setStartButton(true);
+    caller->setStartButton(false);
+    fakeMillis = 2000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(lastDisplay[1], "ready");
+}
+
+TEST_F(CyclicCallerProcessTest, LogicSeesOneSnapshotPerRun) {
+    fakeMillis = 0;
+    caller->initializeTasks();
+    temp.set(42);
+    fakeMillis = 2000;
+    caller->executeCyclicTasks();
+    // the slow input read 42 before the logic run, later reads do not change the image of this run
+    temp.set(80);
+    fakeMillis = 3000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->getLogicProcessImage().getTemperature(), 42_degC);
+    fakeMillis = 4000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(caller->getLogicProcessImage().getTemperature(), 80_degC);
+}
+
+TEST_F(CyclicCallerProcessTest, ScheduledStartRunsWithTheSlotParameters) {
+    // tuesday 12:34, the schedule starts at 12:36 with its own temperature
+    clock.set(951827696);
+    fakeMillis = 0;
+    caller->getSchedule().addSlot(2, 12 * 60 + 36, 70, 10);
+    caller->initializeTasks();
+    temp.set(65);
+    fakeMillis = 2000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(lastDisplay[1], "idle");
+    EXPECT_FALSE(caller->getLogicProcessImage().scheduledStart);
+
+    clock.set(951827696 + 120);
+    fakeMillis = 4000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(lastDisplay[1], "heating");
+    EXPECT_TRUE(caller->getLogicProcessImage().scheduledStart);
+    EXPECT_EQ(caller->getLogicProcessImage().minimumTemperature, 70_degC);
+    EXPECT_EQ(caller->getLogicProcessImage().waitTime, 10u);
+
+    // 65 is enough for the parameter editor, not for the slot
+    fakeMillis = 6000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(lastDisplay[1], "heating");
+    temp.set(70);
+    fakeMillis = 8000;
+    caller->executeCyclicTasks();
+    EXPECT_EQ(lastDisplay[1], "holding");
+}
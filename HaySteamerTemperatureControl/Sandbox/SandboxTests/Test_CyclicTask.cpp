@@ -2,6 +2,8 @@
 #include "gmock/gmock.h"
 #include "../../TaskScheduler.h"
 
+#include <vector>
+
 // Mock for CyclicModule
 class MockCyclicModule : public CyclicModule {
 public:
@@ -89,6 +91,28 @@ TEST(CyclicTaskTest, AddModuleNullptr) {
     EXPECT_NO_THROW(task.cycleTask());
 }
 
+// addModule rejects modules beyond the capacity of the task
+TEST(CyclicTaskTest, AddModuleFailsWhenFull) {
+    TestCyclicTask task(1000);
+    MockCyclicModule m;
+    for (size_t i = 0; i < CyclicTask::maxModules; ++i) {
+        EXPECT_TRUE(task.addModule(&m));
+    }
+    EXPECT_FALSE(task.addModule(&m));
+    EXPECT_EQ(task.modules.size(), CyclicTask::maxModules);
+}
+
+// setModules replaces the modules of the task
+TEST(CyclicTaskTest, SetModulesReplacesModules) {
+    TestCyclicTask task(1000);
+    MockCyclicModule m1, m2, m3;
+    task.addModule(&m1);
+    task.setModules(&m2, &m3);
+    ASSERT_EQ(task.modules.size(), 2u);
+    EXPECT_EQ(task.modules[0], &m2);
+    EXPECT_EQ(task.modules[1], &m3);
+}
+
 // Edge: interval is zero and corrected to minimum value of 10ms
 TEST(CyclicTaskTest, ZeroIntervalSchedulesEveryTime) {
     TestCyclicTask task(0);
@@ -115,4 +139,214 @@ TEST(CyclicTaskTest, IntervalClamping) {
     EXPECT_EQ(t2.interval, 10000u);
     TestCyclicTask t3(500);    // Should keep 500
     EXPECT_EQ(t3.interval, 500u);
-}
\ No newline at end of file
+}
+
+// isRunScheduled counts the runs dropped while catching up
+TEST(CyclicTaskTest, IsRunScheduledCountsMissedCycles) {
+    TestCyclicTask task(100);
+    task.initializeTaskTimer(1000);
+    EXPECT_TRUE(task.isRunScheduled(1100));
+    EXPECT_EQ(task.statistics.missedCycles, 0u);
+    EXPECT_TRUE(task.isRunScheduled(1550)); // 1200, 1300, 1400 and 1500 were due, one run
+    EXPECT_EQ(task.statistics.missedCycles, 3u);
+}
+
+// recordRun tracks min, max and mean run time
+TEST(TaskStatisticsTest, RecordRunTracksRunTimes) {
+    TaskStatistics stats;
+    EXPECT_EQ(stats.getMeanRunTime(), 0u);
+    stats.recordRun(100, 0);
+    stats.recordRun(300, 0);
+    stats.recordRun(200, 0);
+    EXPECT_EQ(stats.runCount, 3u);
+    EXPECT_EQ(stats.minRunTime, 100u);
+    EXPECT_EQ(stats.maxRunTime, 300u);
+    EXPECT_EQ(stats.getMeanRunTime(), 200u);
+}
+
+// recordRun sorts the lateness into the histogram buckets
+TEST(TaskStatisticsTest, RecordRunFillsLatenessHistogram) {
+    TaskStatistics stats;
+    stats.recordRun(0, 0);    // < 1 ms
+    stats.recordRun(0, 1);    // < 2 ms
+    stats.recordRun(0, 4);    // < 5 ms
+    stats.recordRun(0, 99);   // < 100 ms
+    stats.recordRun(0, 100);  // >= 100 ms
+    stats.recordRun(0, 5000); // >= 100 ms
+    EXPECT_EQ(stats.latenessHistogram[0], 1u);
+    EXPECT_EQ(stats.latenessHistogram[1], 1u);
+    EXPECT_EQ(stats.latenessHistogram[2], 1u);
+    EXPECT_EQ(stats.latenessHistogram[3], 0u);
+    EXPECT_EQ(stats.latenessHistogram[6], 1u);
+    EXPECT_EQ(stats.latenessHistogram[7], 2u);
+}
+
+// reset clears all values
+TEST(TaskStatisticsTest, ResetClearsStatistics) {
+    TaskStatistics stats;
+    stats.recordRun(100, 100);
+    stats.missedCycles = 5;
+    stats.reset();
+    EXPECT_EQ(stats.runCount, 0u);
+    EXPECT_EQ(stats.maxRunTime, 0u);
+    EXPECT_EQ(stats.missedCycles, 0u);
+    EXPECT_EQ(stats.latenessHistogram[7], 0u);
+}
+
+// catching up after a very long stall takes constant time
+TEST(CyclicTaskTest, IsRunScheduledCatchesUpLongStall) {
+    TestCyclicTask task(10);
+    task.initializeTaskTimer(0);
+    EXPECT_TRUE(task.isRunScheduled(1000000005)); // 100 million missed slots
+    EXPECT_EQ(task.nextRun, 1000000010u);
+    EXPECT_EQ(task.statistics.missedCycles, 99999999u);
+}
+
+// skip policy runs the slot due now if it is only a little late, drops the missed ones and continues with the next regular slot
+TEST(CyclicTaskTest, SkipPolicyDropsMissedRuns) {
+    TestCyclicTask task(100);
+    task.setMissedRunPolicy(MissedRunPolicy::skip);
+    task.initializeTaskTimer(1000);
+    EXPECT_TRUE(task.isRunScheduled(1110));  // 10 ms late, within the tolerance of 25 ms
+    EXPECT_EQ(task.nextRun, 1200u);
+    EXPECT_TRUE(task.isRunScheduled(1410));  // 1200, 1300 and 1400 due, 1400 runs
+    EXPECT_EQ(task.nextRun, 1500u);
+    EXPECT_EQ(task.statistics.missedCycles, 2u);
+    EXPECT_FALSE(task.isRunScheduled(1410));
+    EXPECT_TRUE(task.isRunScheduled(1500));
+}
+
+// a slot that is too late is dropped with skip, coalesce runs it right away
+TEST(CyclicTaskTest, SkipPolicyWaitsForTheNextSlotWhereCoalesceRuns) {
+    TestCyclicTask skipping(100);
+    skipping.setMissedRunPolicy(MissedRunPolicy::skip);
+    skipping.initializeTaskTimer(1000);
+    TestCyclicTask coalescing(100);
+    coalescing.setMissedRunPolicy(MissedRunPolicy::coalesce);
+    coalescing.initializeTaskTimer(1000);
+
+    EXPECT_TRUE(coalescing.isRunScheduled(1160));
+    EXPECT_FALSE(skipping.isRunScheduled(1160));
+    EXPECT_EQ(skipping.nextRun, 1200u);
+    EXPECT_EQ(skipping.statistics.missedCycles, 1u);
+    EXPECT_FALSE(skipping.isRunScheduled(1199));
+    EXPECT_TRUE(skipping.isRunScheduled(1200));
+
+    // a larger tolerance runs the late slot
+    TestCyclicTask tolerant(100);
+    tolerant.setMissedRunPolicy(MissedRunPolicy::skip);
+    tolerant.setSkipTolerance(80);
+    tolerant.initializeTaskTimer(1000);
+    EXPECT_TRUE(tolerant.isRunScheduled(1160));
+    EXPECT_EQ(tolerant.statistics.missedCycles, 0u);
+}
+
+// a task that always takes longer than its interval still runs with the skip policy
+TEST(CyclicTaskTest, SkipPolicyKeepsAnOverrunningTaskRunning) {
+    TestCyclicTask task(100);
+    task.setMissedRunPolicy(MissedRunPolicy::skip);
+    task.initializeTaskTimer(0);
+    // polled every millisecond: the run takes 250 ms, the slot after it is dropped, the next one runs on time
+    std::vector<unsigned long> starts;
+    for (unsigned long now = 100; now < 1000; ++now) {
+        if (task.isRunScheduled(now)) {
+            starts.push_back(now);
+            now += 250;
+        }
+    }
+    EXPECT_EQ(starts, (std::vector<unsigned long>{ 100, 400, 700 }));
+
+    // polled only 50 ms after every slot: every second slot runs although all are too late
+    TestCyclicTask late(100);
+    late.setMissedRunPolicy(MissedRunPolicy::skip);
+    late.initializeTaskTimer(0);
+    int runs = 0;
+    for (unsigned long now = 150; now < 2150; now += 100) {
+        if (late.isRunScheduled(now)) ++runs;
+    }
+    EXPECT_EQ(runs, 10);
+}
+
+// coalesce policy runs once for all missed slots
+TEST(CyclicTaskTest, CoalescePolicyRunsOnce) {
+    TestCyclicTask task(100);
+    task.setMissedRunPolicy(MissedRunPolicy::coalesce);
+    task.initializeTaskTimer(1000);
+    EXPECT_TRUE(task.isRunScheduled(1450));
+    EXPECT_EQ(task.nextRun, 1500u);
+    EXPECT_FALSE(task.isRunScheduled(1450));
+    EXPECT_EQ(task.statistics.missedCycles, 3u);
+}
+
+// burst policy replays the missed slots up to the burst limit
+TEST(CyclicTaskTest, BurstPolicyReplaysMissedRuns) {
+    TestCyclicTask task(100);
+    task.setMissedRunPolicy(MissedRunPolicy::burst, 2);
+    task.initializeTaskTimer(1000);
+
+    // 1100 .. 1600 due: 1500 and 1600 run, the four slots before are dropped
+    int runs = 0;
+    while (task.isRunScheduled(1650)) {
+        ++runs;
+        ASSERT_LE(runs, 10);
+    }
+    EXPECT_EQ(runs, 2);
+    EXPECT_EQ(task.nextRun, 1700u);
+    EXPECT_EQ(task.statistics.missedCycles, 4u);
+}
+
+// burst policy runs exactly maxBurstRuns times when one slot more is due
+TEST(CyclicTaskTest, BurstPolicyRunsAtMostMaxBurstRuns) {
+    for (uint8_t maxBurst = 1; maxBurst <= 4; ++maxBurst) {
+        TestCyclicTask task(100);
+        task.setMissedRunPolicy(MissedRunPolicy::burst, maxBurst);
+        task.initializeTaskTimer(1000);
+        // maxBurst + 1 slots due
+        const unsigned long now = 1100 + maxBurst * 100UL + 50;
+        int runs = 0;
+        while (task.isRunScheduled(now)) {
+            ++runs;
+            ASSERT_LE(runs, 10);
+        }
+        EXPECT_EQ(runs, maxBurst);
+        EXPECT_EQ(task.statistics.missedCycles, 1u);
+        EXPECT_EQ(task.nextRun, now + 50);
+    }
+}
+
+// burst policy with few missed slots replays all of them
+TEST(CyclicTaskTest, BurstPolicyReplaysAllWithinLimit) {
+    TestCyclicTask task(100);
+    task.setMissedRunPolicy(MissedRunPolicy::burst, 5);
+    task.initializeTaskTimer(1000);
+    int runs = 0;
+    while (task.isRunScheduled(1350)) {
+        ++runs;
+        ASSERT_LE(runs, 10);
+    }
+    EXPECT_EQ(runs, 3); // 1100, 1200 and 1300
+    EXPECT_EQ(task.nextRun, 1400u);
+    EXPECT_EQ(task.statistics.missedCycles, 0u);
+}
+
+// scheduling keeps working when the millisecond counter wraps around
+TEST(CyclicTaskTest, IsRunScheduledHandlesTimerWraparound) {
+    const unsigned long nearWrap = ~0UL - 50; // 50 ms before the counter wraps
+    TestCyclicTask task(100);
+    task.initializeTaskTimer(nearWrap);
+    EXPECT_EQ(task.nextRun, 49u); // wrapped
+    EXPECT_FALSE(task.isRunScheduled(nearWrap + 10)); // still before the wrap
+    EXPECT_FALSE(task.isRunScheduled(20));
+    EXPECT_TRUE(task.isRunScheduled(49));
+    EXPECT_EQ(task.nextRun, 149u);
+}
+
+// catch up across the wraparound
+TEST(CyclicTaskTest, IsRunScheduledCatchesUpAcrossWraparound) {
+    const unsigned long nearWrap = ~0UL - 250;
+    TestCyclicTask task(100);
+    task.initializeTaskTimer(nearWrap);        // next run 150 ms before the wrap
+    EXPECT_TRUE(task.isRunScheduled(120));     // 150 ms before, 50 ms before, 50 ms after the wrap due
+    EXPECT_EQ(task.nextRun, 149u);
+    EXPECT_EQ(task.statistics.missedCycles, 2u);
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "../../DeadlineQueue.h"
+
+// minimal task type, the queue only needs the nextRun member
+struct FakeTask {
+    unsigned long nextRun = 0;
+};
+
+TEST(DeadlineQueueTest, EmptyQueue) {
+    DeadlineQueue<FakeTask, 4> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.top(), nullptr);
+    EXPECT_EQ(queue.nextDeadline(), 0u);
+}
+
+TEST(DeadlineQueueTest, TopIsEarliestDeadline) {
+    DeadlineQueue<FakeTask, 4> queue;
+    FakeTask a{ 300 }, b{ 100 }, c{ 200 };
+    queue.push(&a, 0);
+    queue.push(&b, 1);
+    queue.push(&c, 2);
+
+    EXPECT_EQ(queue.top(), &b);
+    EXPECT_EQ(queue.topSlot(), 1);
+    EXPECT_EQ(queue.nextDeadline(), 100u);
+    queue.pop();
+    EXPECT_EQ(queue.top(), &c);
+    queue.pop();
+    EXPECT_EQ(queue.top(), &a);
+    queue.pop();
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(DeadlineQueueTest, EqualDeadlinesAreOrderedBySlot) {
+    DeadlineQueue<FakeTask, 4> queue;
+    FakeTask a{ 100 }, b{ 100 }, c{ 100 }, d{ 100 };
+    queue.push(&d, 3);
+    queue.push(&b, 1);
+    queue.push(&c, 2);
+    queue.push(&a, 0);
+
+    for (uint8_t slot = 0; slot < 4; ++slot) {
+        EXPECT_EQ(queue.topSlot(), slot);
+        queue.pop();
+    }
+}
+
+TEST(DeadlineQueueTest, PushFailsWhenFull) {
+    DeadlineQueue<FakeTask, 2> queue;
+    FakeTask a, b, c;
+    EXPECT_TRUE(queue.push(&a, 0));
+    EXPECT_TRUE(queue.push(&b, 1));
+    EXPECT_FALSE(queue.push(&c, 2));
+    EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(DeadlineQueueTest, PushIgnoresNullptr) {
+    DeadlineQueue<FakeTask, 2> queue;
+    EXPECT_FALSE(queue.push(nullptr, 0));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(DeadlineQueueTest, UpdateRestoresOrderAfterDeadlineChange) {
+    DeadlineQueue<FakeTask, 4> queue;
+    FakeTask a{ 100 }, b{ 200 }, c{ 300 };
+    queue.push(&a, 0);
+    queue.push(&b, 1);
+    queue.push(&c, 2);
+
+    // move c to the front
+    c.nextRun = 50;
+    queue.update(&c);
+    EXPECT_EQ(queue.top(), &c);
+
+    // move c to the back again
+    c.nextRun = 500;
+    queue.update(&c);
+    EXPECT_EQ(queue.top(), &a);
+    queue.pop();
+    queue.pop();
+    EXPECT_EQ(queue.top(), &c);
+}
+
+TEST(DeadlineQueueTest, ClearRemovesAllTasks) {
+    DeadlineQueue<FakeTask, 4> queue;
+    FakeTask a, b;
+    queue.push(&a, 0);
+    queue.push(&b, 1);
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.top(), nullptr);
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "../../Delegate.h"
+
+#include <string>
+
+namespace {
+    int answer() { return 42; }
+}
+
+TEST(DelegateTest, DefaultIsEmpty) {
+    Delegate<int()> delegate;
+    EXPECT_FALSE(delegate);
+    Delegate<int()> null = nullptr;
+    EXPECT_FALSE(null);
+}
+
+TEST(DelegateTest, CallsFunctionPointer) {
+    Delegate<int()> delegate = &answer;
+    ASSERT_TRUE(delegate);
+    EXPECT_EQ(delegate(), 42);
+}
+
+TEST(DelegateTest, CallsStatelessLambda) {
+    Delegate<int(int, int)> add = [](int a, int b) { return a + b; };
+    EXPECT_EQ(add(2, 3), 5);
+}
+
+TEST(DelegateTest, CallsLambdaCapturingReferences) {
+    int a = 1;
+    int b = 2;
+    Delegate<int()> sum = [&] { return a + b; };
+    EXPECT_EQ(sum(), 3);
+    a = 10;
+    EXPECT_EQ(sum(), 12);
+}
+
+TEST(DelegateTest, CallsLambdaCapturingThis) {
+    struct Source {
+        int value = 7;
+        Delegate<int()> bind() { return [this] { return value; }; }
+    } source;
+    Delegate<int()> delegate = source.bind();
+    source.value = 8;
+    EXPECT_EQ(delegate(), 8);
+}
+
+TEST(DelegateTest, CopyAndReassign) {
+    int calls = 0;
+    Delegate<void()> first = [&] { ++calls; };
+    Delegate<void()> copy = first;
+    copy();
+    first();
+    EXPECT_EQ(calls, 2);
+    copy = nullptr;
+    EXPECT_FALSE(copy);
+    EXPECT_TRUE(first);
+}
+
+TEST(DelegateTest, ReturnsNonTrivialType) {
+    Delegate<std::string(int)> format = [](int value) { return std::to_string(value); };
+    EXPECT_EQ(format(12), "12");
+}
+
+TEST(DelegateTest, FitsTwoPointersAndInvoker) {
+    EXPECT_EQ(sizeof(Delegate<int()>), 3 * sizeof(void*));
+}
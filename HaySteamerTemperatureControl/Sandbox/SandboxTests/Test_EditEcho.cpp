@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "../../EditEcho.h"
+#include "../millis.h"
+
+class EditEchoTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SandboxClock::useVirtualTime = true;
+        SandboxClock::virtualMillis = 0;
+    }
+    void TearDown() override {
+        SandboxClock::useVirtualTime = false;
+    }
+};
+
+TEST_F(EditEchoTest, TriggerIgnoresStateBeforeSetInput) {
+    ChangeCounter editState;
+    editState.markChanged();
+    FastOutputTrigger trigger;
+    int edits = 0;
+    trigger.setActions([&] { ++edits; }, nullptr);
+    trigger.setInput(editState);
+    trigger.update();
+    EXPECT_EQ(edits, 0);
+    EXPECT_FALSE(trigger.isActive());
+}
+
+TEST_F(EditEchoTest, TriggerFiresOnEditAndTimesOutAfterWindow) {
+    ChangeCounter editState;
+    FastOutputTrigger trigger;
+    int edits = 0;
+    int timeouts = 0;
+    trigger.setActions([&] { ++edits; }, [&] { ++timeouts; });
+    trigger.setInput(editState);
+    trigger.setWindow(1000);
+
+    SandboxClock::virtualMillis = 100;
+    editState.markChanged();
+    trigger.update();
+    EXPECT_EQ(edits, 1);
+    EXPECT_TRUE(trigger.isActive());
+
+    // another edit restarts the window
+    SandboxClock::virtualMillis = 800;
+    editState.markChanged();
+    trigger.update();
+    EXPECT_EQ(edits, 2);
+
+    SandboxClock::virtualMillis = 1700;
+    trigger.update();
+    EXPECT_EQ(timeouts, 0);
+
+    SandboxClock::virtualMillis = 1800;
+    trigger.update();
+    EXPECT_EQ(timeouts, 1);
+    EXPECT_FALSE(trigger.isActive());
+
+    trigger.update();
+    EXPECT_EQ(timeouts, 1);
+}
+
+TEST_F(EditEchoTest, ProbeMeasuresKeyToDisplayWrite) {
+    unsigned long writes = 0;
+    KeyEchoProbe probe;
+    probe.setWriteCounter([&] { return writes; });
+
+    probe.keyProcessed(100);
+    probe.keyProcessed(120); // shown by the same write, the oldest key counts
+    SandboxClock::virtualMillis = 150;
+    probe.update();
+    EXPECT_EQ(probe.getStatistics().count, 0u);
+
+    SandboxClock::virtualMillis = 180;
+    ++writes;
+    probe.update();
+    EXPECT_EQ(probe.getStatistics().count, 1u);
+    EXPECT_EQ(probe.getStatistics().max, 80u);
+
+    // a write without a key is not counted
+    ++writes;
+    probe.update();
+    EXPECT_EQ(probe.getStatistics().count, 1u);
+}
+
+TEST(LatencyStatisticsTest, MinMeanMax) {
+    LatencyStatistics statistics;
+    EXPECT_EQ(statistics.getMean(), 0u);
+    statistics.record(10);
+    statistics.record(30);
+    EXPECT_EQ(statistics.count, 2u);
+    EXPECT_EQ(statistics.min, 10u);
+    EXPECT_EQ(statistics.max, 30u);
+    EXPECT_EQ(statistics.getMean(), 20u);
+}
@@ -1,73 +1,127 @@
 #include "gtest/gtest.h"
 #include "../../FaultConditions.h"
 
-// Helper for String type compatibility
-using String = std::string;
-
 // Test fixture for FaultConditions
 class FaultConditionsTest : public ::testing::Test {
 protected:
     FaultConditions faults;
+    ProcessImage image;
+
+    const char* check(Status state) {
+        return faults.getMessage(faults.checkConditions(state, image));
+    }
 };
 
-// No conditions, default message is empty
+// No conditions, no fault
 TEST_F(FaultConditionsTest, NoConditionsReturnsDefaultMessage) {
-    EXPECT_EQ(faults.checkConditions(Status::idle), "");
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
 }
 
-// Single condition true, returns its message
+// Single condition true, returns its code
 TEST_F(FaultConditionsTest, SingleTrueConditionReturnsMessage) {
-    faults.addCondition([](Status) { return true; }, "Fault1");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "Fault1");
+    faults.addCondition([](const ProcessImage&) { return true; }, "Fault1");
+    EXPECT_STREQ(check(Status::idle), "Fault1");
 }
 
 // Single condition false, returns default message
 TEST_F(FaultConditionsTest, SingleFalseConditionReturnsDefault) {
-    faults.addCondition([](Status) { return false; }, "Fault1");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "");
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault1");
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
 }
 
 // Multiple conditions, first true is returned
 TEST_F(FaultConditionsTest, MultipleConditionsFirstTrueReturned) {
-    faults.addCondition([](Status) { return false; }, "Fault1");
-    faults.addCondition([](Status) { return true; }, "Fault2");
-    faults.addCondition([](Status) { return true; }, "Fault3");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "Fault2");
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault1");
+    faults.addCondition([](const ProcessImage&) { return true; }, "Fault2");
+    faults.addCondition([](const ProcessImage&) { return true; }, "Fault3");
+    EXPECT_STREQ(check(Status::idle), "Fault2");
 }
 
 // Multiple conditions, all false, returns default
 TEST_F(FaultConditionsTest, MultipleConditionsAllFalseReturnsDefault) {
-    faults.addCondition([](Status) { return false; }, "Fault1");
-    faults.addCondition([](Status) { return false; }, "Fault2");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "");
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault1");
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault2");
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
 }
 
 // Add null condition, should be ignored
 TEST_F(FaultConditionsTest, AddNullConditionIgnored) {
     int callCount = 0;
-    faults.addCondition(nullptr, "Fault1");
-    faults.addCondition([&](Status) { ++callCount; return false; }, "Fault2");
-    faults.checkConditions(Status::idle);
+    EXPECT_FALSE(faults.addCondition(nullptr, "Fault1"));
+    faults.addCondition([&](const ProcessImage&) { ++callCount; return false; }, "Fault2");
+    faults.checkConditions(Status::idle, image);
     EXPECT_EQ(callCount, 1);
 }
 
 // Multiple calls to checkConditions, state is preserved
 TEST_F(FaultConditionsTest, MultipleCallsPreserveState) {
-    faults.addCondition([](Status) { return false; }, "Fault1");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "");
-    faults.addCondition([](Status) { return true; }, "Fault2");
-    EXPECT_EQ(faults.checkConditions(Status::idle), "Fault2");
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault1");
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
+    faults.addCondition([](const ProcessImage&) { return true; }, "Fault2");
+    EXPECT_STREQ(check(Status::idle), "Fault2");
+}
+
+// The conditions read their inputs from the process image
+TEST_F(FaultConditionsTest, ConditionReadsProcessImage) {
+    faults.addCondition([](const ProcessImage& image) { return image.getTemperature() > 100_degC; }, "Overheat");
+    image.temperature = 99_degC;
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
+    image.temperature = 101_degC;
+    EXPECT_STREQ(check(Status::idle), "Overheat");
 }
 
 TEST_F(FaultConditionsTest, ConditionTrueForSpecificStates) {
-    // Condition returns true only for heating and holding
-    faults.addCondition([](Status s) {
-        return s == Status::heating || s == Status::holding;
-        }, "Active");
-
-    EXPECT_EQ(faults.checkConditions(Status::idle), "");
-    EXPECT_EQ(faults.checkConditions(Status::heating), "Active");
-    EXPECT_EQ(faults.checkConditions(Status::holding), "Active");
-    EXPECT_EQ(faults.checkConditions(Status::done), "");
-    EXPECT_EQ(faults.checkConditions(Status::error), "");
-}
\ No newline at end of file
+    // Condition applies only to heating and holding
+    int checks = 0;
+    faults.addCondition([&](const ProcessImage&) { ++checks; return true; }, "Active",
+        statusBit(Status::heating) | statusBit(Status::holding));
+
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
+    EXPECT_STREQ(check(Status::heating), "Active");
+    EXPECT_STREQ(check(Status::holding), "Active");
+    EXPECT_EQ(faults.checkConditions(Status::done, image), noFault);
+    EXPECT_EQ(faults.checkConditions(Status::error, image), noFault);
+    // the rule is not even evaluated in the other states
+    EXPECT_EQ(checks, 2);
+    EXPECT_EQ(faults.getRuleCount(Status::heating), 1u);
+    EXPECT_EQ(faults.getRuleCount(Status::idle), 0u);
+}
+
+// Higher priority first, equal priorities in the order they were added, the code stays the position
+TEST_F(FaultConditionsTest, HigherPriorityIsCheckedFirst) {
+    faults.addCondition([](const ProcessImage&) { return true; }, "Low", FaultConditions::allStates, 1);
+    faults.addCondition([](const ProcessImage&) { return true; }, "High", FaultConditions::allStates, 5);
+    faults.addCondition([](const ProcessImage&) { return true; }, "High too", FaultConditions::allStates, 5);
+    EXPECT_STREQ(check(Status::idle), "High");
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), 2);
+}
+
+// Evaluation stops at the first rule met
+TEST_F(FaultConditionsTest, EvaluationStopsAtFirstFault) {
+    int later = 0;
+    faults.addCondition([](const ProcessImage&) { return true; }, "Fault1");
+    faults.addCondition([&](const ProcessImage&) { ++later; return true; }, "Fault2");
+    check(Status::idle);
+    EXPECT_EQ(later, 0);
+}
+
+// Conditions beyond the capacity are rejected
+TEST_F(FaultConditionsTest, AddConditionFailsWhenFull) {
+    for (size_t i = 0; i < FaultConditions::maxConditions; ++i) {
+        EXPECT_TRUE(faults.addCondition([](const ProcessImage&) { return false; }, "Fault"));
+    }
+    EXPECT_FALSE(faults.addCondition([](const ProcessImage&) { return true; }, "Overflow"));
+    EXPECT_EQ(faults.checkConditions(Status::idle, image), noFault);
+}
+
+// The code is the position of the condition, its message is kept as a pointer
+TEST_F(FaultConditionsTest, CodeIdentifiesCondition) {
+    static const char sensorFault[] = "sensor fault";
+    faults.addCondition([](const ProcessImage&) { return false; }, "Fault1");
+    faults.addCondition([](const ProcessImage&) { return true; }, sensorFault);
+    FaultCode code = faults.checkConditions(Status::idle, image);
+    EXPECT_EQ(code, 2);
+    EXPECT_EQ(faults.getMessage(code), sensorFault);
+    EXPECT_STREQ(faults.getMessage(noFault), "");
+    EXPECT_STREQ(faults.getMessage(5), "");
+}
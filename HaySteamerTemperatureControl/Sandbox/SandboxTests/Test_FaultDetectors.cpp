@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "../../FaultDetectors.h"
+
+// --- RollingSlope ---
+
+TEST(RollingSlopeTest, SlopeOfALineIsExact) {
+    RollingSlope<int, 5> slope(2000); // one sample every 2 s
+    EXPECT_EQ(slope.getSlopePerMinute(), 0);
+    for (int i = 0; i < 3; ++i) {
+        slope.update(20 + i);
+    }
+    EXPECT_FALSE(slope.isFull());
+    EXPECT_EQ(slope.getSlopePerMinute(), 30); // 1 degree per sample, 30 samples per minute
+}
+
+TEST(RollingSlopeTest, OnlyTheWindowCounts) {
+    RollingSlope<int, 4> slope(60000); // one sample per minute
+    for (int value : { 100, 50, 0, 10, 20, 30, 40 }) {
+        slope.update(value);
+    }
+    EXPECT_TRUE(slope.isFull());
+    EXPECT_EQ(slope.getSlopePerMinute(), 10);
+    for (int value : { 30, 20, 10, 0 }) {
+        slope.update(value);
+    }
+    EXPECT_EQ(slope.getSlopePerMinute(), -10);
+}
+
+TEST(RollingSlopeTest, NoisyFlatSignalHasSmallSlope) {
+    RollingSlope<int, 8> slope(60000);
+    for (int i = 0; i < 40; ++i) {
+        slope.update(60 + ((i % 2) ? 1 : -1));
+    }
+    EXPECT_EQ(slope.getSlopePerMinute(), 0);
+    slope.reset();
+    EXPECT_EQ(slope.getSlopePerMinute(), 0);
+}
+
+TEST(RollingSlopeTest, TemperatureSlopeKeepsFractionsOfADegree) {
+    // a hundredth of a degree per second is 0.6 degree per minute, whole degrees would read 0 or 1
+    RollingSlope<Temperature, 60> slope(1000);
+    for (long i = 0; i < 90; ++i) {
+        slope.update(60_degC + Temperature::fromCentiCelsius(i));
+    }
+    EXPECT_EQ(slope.getSlopePerMinute(), 0.6_degC);
+    // 0.25 degree per 2 s sample at bale temperatures
+    RollingSlope<Temperature, 8> steep(2000);
+    for (long i = 0; i < 8; ++i) {
+        steep.update(70_degC - 0.25_degC * i);
+    }
+    EXPECT_EQ(steep.getSlopePerMinute(), -7.5_degC);
+}
+
+// --- NOfM ---
+
+TEST(NOfMTest, TripsOnNHitsOfM) {
+    NOfM<5> detector(3, 1);
+    EXPECT_FALSE(detector.update(true));
+    EXPECT_FALSE(detector.update(false));
+    EXPECT_FALSE(detector.update(true));
+    EXPECT_TRUE(detector.update(true));
+    EXPECT_EQ(detector.getHits(), 3);
+}
+
+TEST(NOfMTest, ClearsWithHysteresis) {
+    NOfM<4> detector(3, 1);
+    for (int i = 0; i < 4; ++i) detector.update(true);
+    ASSERT_TRUE(detector.isActive());
+    // 2 hits left: below the trip count, still above the clear count
+    EXPECT_TRUE(detector.update(false));
+    EXPECT_TRUE(detector.update(false));
+    // 1 hit left: cleared
+    EXPECT_FALSE(detector.update(false));
+    EXPECT_FALSE(detector.update(true));
+    detector.reset();
+    EXPECT_EQ(detector.getHits(), 0);
+}
+
+TEST(NOfMTest, FullWindowOf32) {
+    NOfM<32> detector(32, 0);
+    for (int i = 0; i < 31; ++i) EXPECT_FALSE(detector.update(true));
+    EXPECT_TRUE(detector.update(true));
+    EXPECT_TRUE(detector.update(true)); // old hits leave, new hits come in
+    EXPECT_EQ(detector.getHits(), 32);
+}
+
+// --- NoRiseDetector ---
+
+TEST(NoRiseDetectorTest, TripsWithoutRise) {
+    NoRiseDetector detector(2, 10000);
+    EXPECT_FALSE(detector.update(20, 0));
+    EXPECT_FALSE(detector.update(21, 5000)); // rise too small
+    EXPECT_TRUE(detector.update(21, 10000));
+}
+
+TEST(NoRiseDetectorTest, RiseRestartsTheWindow) {
+    NoRiseDetector detector(2, 10000);
+    detector.update(20, 0);
+    EXPECT_FALSE(detector.update(22, 9000));
+    EXPECT_FALSE(detector.update(23, 18000));
+    EXPECT_TRUE(detector.update(23, 19000));
+    detector.reset();
+    EXPECT_FALSE(detector.isActive());
+    EXPECT_FALSE(detector.update(23, 19000));
+}
+
+TEST(NoRiseDetectorTest, LimitsCanBeChangedAndZeroWindowTurnsItOff) {
+    NoRiseDetector detector(2, 10000);
+    detector.setLimits(1, 20000);
+    EXPECT_EQ(detector.getMinRise(), 1);
+    EXPECT_EQ(detector.getWindow(), 20000u);
+    detector.update(20, 0);
+    EXPECT_FALSE(detector.update(20, 10000));
+    EXPECT_TRUE(detector.update(20, 20000));
+    detector.setLimits(1, 0);
+    EXPECT_FALSE(detector.isActive());
+    detector.update(20, 20000);
+    EXPECT_FALSE(detector.update(20, 100000));
+}
+
+TEST(NoRiseDetectorTest, WorksAcrossTimerWraparound) {
+    NoRiseDetector detector(1, 10000);
+    detector.update(20, ~0UL - 4000);
+    EXPECT_FALSE(detector.update(20, 4000));
+    EXPECT_TRUE(detector.update(20, 6000));
+}
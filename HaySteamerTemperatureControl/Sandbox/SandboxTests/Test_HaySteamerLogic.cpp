@@ -1,32 +1,18 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "../../HaySteamerLogic.h"
+#include "../../ProbeFusion.h"
 
-// Helper types for compatibility
-using String = std::string;
-
-// Mock functions for input
+// Mock functions for the conditions, the values come with the process image
 struct HaySteamerLogicMocks {
     MOCK_METHOD(bool, startConditions, (), (const));
-    MOCK_METHOD(bool, startTimer, (), (const));
     MOCK_METHOD(bool, runTimer, (), (const));
-    MOCK_METHOD(unsigned long, getTimeOfDayInMinutes, (), (const));
-    MOCK_METHOD(int, getTemperature, (), (const));
-    MOCK_METHOD(int, getMinimumTemperature, (), (const));
-    MOCK_METHOD(unsigned long, getWaitTime, (), (const));
-    MOCK_METHOD(String, hasFault, (Status), (const));
 };
 
-// Helper to set all input functions
+// Helper to set all condition functions
 void setAllInputs(HaySteamerLogic& logic, HaySteamerLogicMocks& mocks) {
     logic.setStartConditions([&] { return mocks.startConditions(); });
-    logic.setStartTimer([&] { return mocks.startTimer(); });
     logic.setRunTimer([&] { return mocks.runTimer(); });
-    logic.setGetTimeOfDayInMinutes([&] { return mocks.getTimeOfDayInMinutes(); });
-    logic.setGetTemperature([&] { return mocks.getTemperature(); });
-    logic.setGetMinimumTemperature([&] { return mocks.getMinimumTemperature(); });
-    logic.setGetWaitTime([&] { return mocks.getWaitTime(); });
-    logic.setHasFault([&](Status s) { return mocks.hasFault(s); });
 }
 
 // Test fixture
@@ -34,216 +20,364 @@ class HaySteamerLogicTest : public ::testing::Test {
 protected:
     HaySteamerLogic logic;
     HaySteamerLogicMocks mocks;
+    ProcessImage image;
     void SetUp() override {
         setAllInputs(logic, mocks);
+        image.minimumTemperature = 60_degC;
+        image.waitTime = 30;
+    }
+
+    void toHeating(unsigned long time = 100) {
+        EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
+        image.timeOfDayInMinutes = time;
+        logic.update(image);
+        ASSERT_EQ(logic.getCurrentStatus(), Status::heating);
+    }
+
+    void toHolding(unsigned long time = 200) {
+        toHeating();
+        image.temperature = 60_degC;
+        image.timeOfDayInMinutes = time;
+        logic.update(image);
+        ASSERT_EQ(logic.getCurrentStatus(), Status::holding);
     }
 };
 
 // Test: Initial status is idle, update with startConditions true triggers heating
 TEST_F(HaySteamerLogicTest, IdleToHeatingTransition) {
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHeating();
     EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
-    EXPECT_EQ(logic.getMessage(), "heating");
+    EXPECT_STREQ(logic.getMessage(), "heating");
 }
 
-// Test: Idle, startConditions false, startTimer true triggers ready
+// Test: Idle, startConditions false, start button pressed triggers ready
 TEST_F(HaySteamerLogicTest, IdleToReadyTransition) {
     EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, startTimer()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, hasFault(Status::ready)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.startButton = true;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::ready);
-    EXPECT_EQ(logic.getMessage(), "ready");
+    EXPECT_STREQ(logic.getMessage(), "ready");
 }
 
-// Test: Idle, startConditions false, startTimer false stays idle
+// Test: Idle, startConditions false, start button not pressed stays idle
 TEST_F(HaySteamerLogicTest, IdleNoStartConditionOrTimerStaysIdle) {
     EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, startTimer()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, hasFault(Status::idle)).WillOnce(::testing::Return(""));
-    logic.update();
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::idle);
-    EXPECT_EQ(logic.getMessage(), "idle");
+    EXPECT_STREQ(logic.getMessage(), "idle");
 }
 
 // Test: Ready, runTimer true triggers heating
 TEST_F(HaySteamerLogicTest, ReadyToHeatingTransition) {
     // Move to ready first
     EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, startTimer()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, hasFault(Status::ready)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.startButton = true;
+    logic.update(image);
     // Now, ready: runTimer true
     EXPECT_CALL(mocks, runTimer()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(101));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(61));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.startButton = false;
+    image.timeOfDayInMinutes = 101;
+    image.minimumTemperature = 61_degC;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
-    EXPECT_EQ(logic.getMessage(), "heating");
+    EXPECT_STREQ(logic.getMessage(), "heating");
 }
 
 // Test: Ready, runTimer false stays ready
 TEST_F(HaySteamerLogicTest, ReadyNoRunTimerStaysReady) {
     // Move to ready first
     EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, startTimer()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, hasFault(Status::ready)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.startButton = true;
+    logic.update(image);
     // Now, ready: runTimer false
     EXPECT_CALL(mocks, runTimer()).WillOnce(::testing::Return(false));
-    EXPECT_CALL(mocks, hasFault(Status::ready)).WillOnce(::testing::Return(""));
-    logic.update();
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::ready);
 }
 
 // Test: Heating to Holding transition when temperature >= minimumTemperature
 TEST_F(HaySteamerLogicTest, HeatingToHoldingTransition) {
-    // Move to heating
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
-    // Now, heating: temperature >= minimumTemperature
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(60));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(200));
-    EXPECT_CALL(mocks, getWaitTime()).WillOnce(::testing::Return(30));
-    EXPECT_CALL(mocks, hasFault(Status::holding)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHolding();
     EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
-    EXPECT_EQ(logic.getMessage(), "holding");
+    EXPECT_STREQ(logic.getMessage(), "holding");
 }
 
 // Test: Heating, temperature < minimumTemperature, stays in heating
 TEST_F(HaySteamerLogicTest, HeatingNoTempStaysHeating) {
-    // Move to heating
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHeating();
     // Now, heating: temperature < minimumTemperature
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(59));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.temperature = 59_degC;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
+}
+
+// Test: the minimum temperature is taken from the image when heating starts, later changes do not apply
+TEST_F(HaySteamerLogicTest, MinimumTemperatureIsFixedWhenHeatingStarts) {
+    toHeating();
+    image.minimumTemperature = 50_degC;
+    image.temperature = 55_degC;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
 }
 
 // Test: Holding to Done transition when wait time elapsed
 TEST_F(HaySteamerLogicTest, HoldingToDoneTransition) {
-    // Move to holding
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(60));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(200));
-    EXPECT_CALL(mocks, getWaitTime()).WillOnce(::testing::Return(30));
-    EXPECT_CALL(mocks, hasFault(Status::holding)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHolding();
     // Now, holding: time elapsed
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(231)); // 200+31 >= 30
-    EXPECT_CALL(mocks, hasFault(Status::done)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.timeOfDayInMinutes = 231; // 200+31 >= 30
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::done);
-    EXPECT_EQ(logic.getMessage(), "done");
+    EXPECT_STREQ(logic.getMessage(), "done");
 }
 
 // Test: Done to Idle transition after 60 minutes
 TEST_F(HaySteamerLogicTest, DoneToIdleTransition) {
-    // Move to done
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(60));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(200));
-    EXPECT_CALL(mocks, getWaitTime()).WillOnce(::testing::Return(30));
-    EXPECT_CALL(mocks, hasFault(Status::holding)).WillOnce(::testing::Return(""));
-    logic.update();
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(231));
-    EXPECT_CALL(mocks, hasFault(Status::done)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHolding();
+    image.timeOfDayInMinutes = 231;
+    logic.update(image);
     // Now, done: timeWhenDone = 231, time = 291 (231+60)
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(291));
-    EXPECT_CALL(mocks, hasFault(Status::idle)).WillOnce(::testing::Return(""));
-    logic.update();
+    image.timeOfDayInMinutes = 291;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::idle);
-    EXPECT_EQ(logic.getMessage(), "idle");
+    EXPECT_STREQ(logic.getMessage(), "idle");
 }
 
 // Test: Heating timeout triggers error
 TEST_F(HaySteamerLogicTest, HeatingTimeoutTriggersError) {
-    // Move to heating
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHeating();
     // Now, heating: timeOfDay - actualStartTime > heatingTimeout
-    EXPECT_CALL(mocks, getTemperature()).WillOnce(::testing::Return(59));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(161)); // 100+61 > 60
-    logic.update();
+    image.temperature = 59_degC;
+    image.timeOfDayInMinutes = 161; // 100+61 > 60
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::error);
-    EXPECT_EQ(logic.getMessage(), "heating timeout");
+    EXPECT_STREQ(logic.getMessage(), "heating timeout");
 }
 
 // Test: Holding temperature drop triggers error
 TEST_F(HaySteamerLogicTest, HoldingTemperatureDropTriggersError) {
-    // Move to holding
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(60));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(200));
-    EXPECT_CALL(mocks, getWaitTime()).WillOnce(::testing::Return(30));
-    EXPECT_CALL(mocks, hasFault(Status::holding)).WillOnce(::testing::Return(""));
-    logic.update();
+    toHolding();
     // Now, holding: temperature < minimumTemperature - holdingTemperatureDrop
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillOnce(::testing::Return(200));
-    EXPECT_CALL(mocks, getTemperature()).WillOnce(::testing::Return(54)); // 60-5=55, so 54 triggers
-    logic.update();
+    image.temperature = 54_degC; // 60-5=55, so 54 hits
+    logic.update(image);
+    // a single low sample is taken as noise
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::error);
+    EXPECT_STREQ(logic.getMessage(), "temperature drop");
+}
+
+// Test: single low samples between good ones do not trip the temperature drop
+TEST_F(HaySteamerLogicTest, SingleLowSamplesAreIgnored) {
+    toHolding();
+    for (int i = 0; i < 10; ++i) {
+        image.temperature = (i % 3 == 0) ? 40_degC : 60_degC;
+        logic.update(image);
+    }
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+}
+
+// Test: no rise while heating is caught long before the heating timeout
+TEST_F(HaySteamerLogicTest, HeatingStallTriggersError) {
+    image.timeStamp = 1000;
+    image.temperature = 20_degC;
+    toHeating();
+    // rising by one degree per 10 minutes keeps it going
+    for (int i = 1; i <= 3; ++i) {
+        image.timeStamp += 10 * 60000UL;
+        image.temperature += 1_degC;
+        logic.update(image);
+    }
+    EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
+    // then 15 minutes without a rise
+    image.timeStamp += 15 * 60000UL;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::error);
-    EXPECT_EQ(logic.getMessage(), "temperature drop");
+    EXPECT_STREQ(logic.getMessage(), "heating stalled");
 }
 
-// Test: hasFault returns error message, triggers error
+// Test: a slow but steady rise in quarter degree steps never trips the stall fault
+TEST_F(HaySteamerLogicTest, SlowSteadyRiseDoesNotStall) {
+    image.timeStamp = 1000;
+    image.temperature = 20_degC;
+    toHeating();
+    // 1 degree per 15 minutes, in steps of a quarter degree, for two hours
+    for (int step = 1; step <= 32; ++step) {
+        image.timeStamp += 225000UL;
+        image.temperature += 0.25_degC;
+        logic.update(image);
+        ASSERT_EQ(logic.getCurrentStatus(), Status::heating) << "step " << step;
+    }
+}
+
+// Test: a big bale rising half a degree per 25 minutes needs a longer stall window
+TEST_F(HaySteamerLogicTest, StallLimitsAreConfigurable) {
+    EXPECT_EQ(logic.getHeatingStallRise(), 1_degC);
+    EXPECT_EQ(logic.getHeatingStallWindow(), 15 * 60000UL);
+    logic.setHeatingStallLimits(0.5_degC, 30 * 60000UL);
+    image.timeStamp = 1000;
+    image.temperature = 20_degC;
+    toHeating();
+    for (int step = 1; step <= 4; ++step) {
+        image.timeStamp += 25 * 60000UL;
+        image.temperature += 0.5_degC;
+        logic.update(image);
+        ASSERT_EQ(logic.getCurrentStatus(), Status::heating) << "step " << step;
+    }
+    image.timeStamp += 30 * 60000UL;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::error);
+    EXPECT_STREQ(logic.getMessage(), "heating stalled");
+}
+
+// Test: probes that keep disagreeing while holding stop the run, a single disagreement does not
+TEST_F(HaySteamerLogicTest, ProbeDisagreementTriggersError) {
+    toHolding();
+    image.probesDisagree = true;
+    logic.update(image);
+    image.probesDisagree = false;
+    logic.update(image);
+    image.probesDisagree = true;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::error);
+    EXPECT_STREQ(logic.getMessage(), "probes disagree");
+}
+
+// Test: while heating the cold core lags the probe near the steam by far more than the outlier limit, that is no fault
+TEST_F(HaySteamerLogicTest, HeatingSpreadOfTheProbesIsNoFault) {
+    ProbeFusion<2> fusion;
+    ProbeSample probes[2];
+    probes[0].valid = probes[1].valid = true;
+    image.timeStamp = 1000;
+    toHeating();
+    // steam side from 20 to 92 C, core from 15 to 55.5 C over 90 minutes, more than 35 C apart at the end
+    for (int minute = 0; minute <= 90; ++minute) {
+        probes[0].value = 20_degC + Temperature::fromCentiCelsius(minute * 80);
+        probes[1].value = 15_degC + Temperature::fromCentiCelsius(minute * 45);
+        const FusionResult fused = fusion.fuse(probes, 2);
+        image.temperature = fused.value;
+        image.probesDisagree = fused.disagreement;
+        image.timeStamp += 60000;
+        image.timeOfDayInMinutes = 100 + minute / 2;
+        logic.update(image);
+        ASSERT_EQ(logic.getCurrentStatus(), Status::heating) << "minute " << minute;
+    }
+    EXPECT_TRUE(image.probesDisagree);
+}
+
+// Test: an open probe stops heating and holding, a single bad sample does not
+TEST_F(HaySteamerLogicTest, FailedProbeTriggersError) {
+    image.probeCount = 2;
+    toHeating();
+    image.failedProbes = 0b01;
+    logic.update(image);
+    image.failedProbes = 0;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::heating);
+    image.failedProbes = 0b01;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::error);
+    EXPECT_STREQ(logic.getMessage(), "probe failed");
+}
+
+// Test: all probes failing while holding stops the run although the frozen temperature looks fine
+TEST_F(HaySteamerLogicTest, AllProbesFailingWhileHoldingTriggersError) {
+    image.probeCount = 2;
+    toHolding();
+    image.failedProbes = 0b11;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::error);
+    EXPECT_STREQ(logic.getMessage(), "probe failed");
+}
+
+// Test: attached detectors are fed with every logic run, whatever the state
+TEST_F(HaySteamerLogicTest, DetectorsAreFedEveryRun) {
+    int samples = 0;
+    EXPECT_TRUE(logic.addFaultDetector([&samples](const ProcessImage&) { ++samples; }));
+    EXPECT_CALL(mocks, startConditions()).WillRepeatedly(::testing::Return(false));
+    logic.update(image);
+    logic.update(image);
+    EXPECT_EQ(samples, 2);
+}
+
+// Test: an attached fault condition triggers error
 TEST_F(HaySteamerLogicTest, HasFaultTriggersError) {
-    // Move to heating
-    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(true));
-    EXPECT_CALL(mocks, getTimeOfDayInMinutes()).WillRepeatedly(::testing::Return(100));
-    EXPECT_CALL(mocks, getMinimumTemperature()).WillOnce(::testing::Return(60));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return(""));
-    logic.update();
-    // Now, heating: no timeout, but hasFault returns error
-    EXPECT_CALL(mocks, getTemperature()).WillRepeatedly(::testing::Return(59));
-    EXPECT_CALL(mocks, hasFault(Status::heating)).WillOnce(::testing::Return("custom fault"));
-    logic.update();
+    toHeating();
+    // Now, heating: no timeout, but the attached condition is met
+    int checks = 0;
+    logic.addFaultCondition([&checks](const ProcessImage&) { ++checks; return true; }, "custom fault", statusBit(Status::heating));
+    image.temperature = 59_degC;
+    logic.update(image);
     EXPECT_EQ(logic.getCurrentStatus(), Status::error);
-    EXPECT_EQ(logic.getMessage(), "custom fault");
+    EXPECT_STREQ(logic.getMessage(), "custom fault");
+    EXPECT_EQ(checks, 1);
+}
+
+// Test: attached conditions are only checked in their states, the built-in faults come first
+TEST_F(HaySteamerLogicTest, AttachedFaultsAreCheckedInTheirStatesAfterBuiltIns) {
+    int checks = 0;
+    logic.addFaultCondition([&checks](const ProcessImage&) { ++checks; return true; }, "custom fault", statusBit(Status::holding));
+    toHeating();
+    image.temperature = 59_degC;
+    logic.update(image);
+    EXPECT_EQ(checks, 0);
+    // heating timeout and the custom fault are met, the built-in one wins
+    image.timeOfDayInMinutes = 161;
+    logic.update(image);
+    EXPECT_STREQ(logic.getMessage(), "heating timeout");
+    EXPECT_EQ(checks, 0);
+}
+
+// Test: update() captures the process image once per run and decides on it
+TEST_F(HaySteamerLogicTest, UpdateCapturesProcessImageOncePerRun) {
+    int captures = 0;
+    logic.setCapture([&](ProcessImage& captured) {
+        ++captures;
+        captured.startButton = true;
+        captured.timeOfDayInMinutes = 42;
+    });
+    EXPECT_CALL(mocks, startConditions()).WillOnce(::testing::Return(false));
+    logic.update();
+    EXPECT_EQ(captures, 1);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::ready);
+    EXPECT_EQ(logic.getProcessImage().timeOfDayInMinutes, 42u);
 }
 
 // Test: set* functions ignore nullptr
 TEST_F(HaySteamerLogicTest, SetFunctionsIgnoreNullptr) {
     HaySteamerLogic l;
+    l.setCapture(nullptr);
     l.setStartConditions(nullptr);
-    l.setStartTimer(nullptr);
     l.setRunTimer(nullptr);
-    l.setGetTimeOfDayInMinutes(nullptr);
-    l.setGetTemperature(nullptr);
-    l.setGetMinimumTemperature(nullptr);
-    l.setGetWaitTime(nullptr);
-    l.setHasFault(nullptr);
-    // Should not crash, but update will likely throw if called
-    EXPECT_NO_THROW(l.getMessage());
-    EXPECT_NO_THROW(l.getCurrentStatus());
-}
\ No newline at end of file
+    EXPECT_FALSE(l.addFaultCondition(nullptr, "fault"));
+    EXPECT_NO_THROW(l.update());
+    EXPECT_EQ(l.getCurrentStatus(), Status::idle);
+    EXPECT_STREQ(l.getMessage(), "idle");
+}
+
+// Test: messages are entries of the constant table, not copies
+TEST_F(HaySteamerLogicTest, MessagesPointIntoTheTable) {
+    static_assert(getMessageText(MessageId::temperatureDrop)[0] == 't', "table is usable at compile time");
+    EXPECT_EQ(logic.getMessage(), getMessageText(MessageId::idle));
+    toHeating();
+    EXPECT_EQ(logic.getMessage(), getMessageText(MessageId::heating));
+    EXPECT_STREQ(getMessageText(MessageId::count), "");
+}
+
+// Test: a run across midnight is timed by the minutes since the phase started
+TEST_F(HaySteamerLogicTest, TimingWorksAcrossMidnight) {
+    toHeating(1430); // 23:50
+    image.temperature = 60_degC;
+    image.timeOfDayInMinutes = 10; // 00:10, 20 minutes later, no heating timeout
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+    image.timeOfDayInMinutes = 39;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::holding);
+    image.timeOfDayInMinutes = 40;
+    logic.update(image);
+    EXPECT_EQ(logic.getCurrentStatus(), Status::done);
+}
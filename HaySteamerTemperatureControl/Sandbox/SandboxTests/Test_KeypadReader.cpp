@@ -38,4 +38,51 @@ TEST(KeypadReaderTest, MultipleUpdatesStoreLatestValue) {
     EXPECT_EQ(reader.getLatestValue(), 'A');
     reader.update();
     EXPECT_EQ(reader.getLatestValue(), '#');
-}
\ No newline at end of file
+}
+TEST(KeypadReaderTest, ReadKeyQueuesKeyWithTimeStamp) {
+    MockKeypad mockKeypad;
+    KeypadReader reader(&mockKeypad);
+
+    EXPECT_CALL(mockKeypad, read())
+        .WillOnce(Return('1'))
+        .WillOnce(Return('#'));
+
+    EXPECT_TRUE(reader.readKey(100));
+    EXPECT_TRUE(reader.readKey(130));
+    EXPECT_EQ(reader.getPendingKeys(), 2u);
+
+    KeyEvent event{};
+    ASSERT_TRUE(reader.getNextEvent(event));
+    EXPECT_EQ(event.key, '1');
+    EXPECT_EQ(event.timeStamp, 100u);
+    ASSERT_TRUE(reader.getNextEvent(event));
+    EXPECT_EQ(event.key, '#');
+    EXPECT_EQ(event.timeStamp, 130u);
+    EXPECT_FALSE(reader.getNextEvent(event));
+}
+
+TEST(KeypadReaderTest, NoKeyAndFailedReadAreNotQueued) {
+    MockKeypad mockKeypad;
+    KeypadReader reader(&mockKeypad);
+
+    EXPECT_CALL(mockKeypad, read())
+        .WillOnce(Return('N'))
+        .WillOnce(Return('F'));
+
+    EXPECT_FALSE(reader.readKey(100));
+    EXPECT_FALSE(reader.readKey(200));
+    EXPECT_EQ(reader.getLatestValue(), 'F');
+    EXPECT_EQ(reader.getNextKey(), '\0');
+}
+
+TEST(KeypadReaderTest, KeysBeyondQueueSizeAreDropped) {
+    MockKeypad mockKeypad;
+    KeypadReader reader(&mockKeypad);
+
+    EXPECT_CALL(mockKeypad, read()).WillRepeatedly(Return('5'));
+    for (size_t i = 0; i < KeypadReader::queueSize; ++i) {
+        reader.readKey(i);
+    }
+    EXPECT_EQ(reader.getPendingKeys(), KeypadReader::queueSize - 1);
+    EXPECT_EQ(reader.getDroppedKeys(), 1u);
+}
@@ -123,4 +123,39 @@ TEST(OutputTaskTest, EnableFastNoNextRunAdjustmentIfNotNeeded) {
     task.nextRun = 1050; // lastRun + fastInterval == 1100, which is > nextRun
     task.enableFast();
     EXPECT_EQ(task.nextRun, 1050u);
-}
\ No newline at end of file
+}
+// Edge: catch up in fast mode after a long stall
+TEST(OutputTaskTest, IsRunScheduledLongStallFastMode) {
+    TestOutputTask task(1000, 100);
+    task.enabledFast = true;
+    task.nextRun = 1000;
+    EXPECT_TRUE(task.isRunScheduled(10001050));
+    EXPECT_EQ(task.nextRun, 10001100u);
+    EXPECT_EQ(task.lastRun, 10001050u);
+}
+
+// Edge: enableFast compares time stamps across the wraparound of the timer
+TEST(OutputTaskTest, EnableFastHandlesTimerWraparound) {
+    TestOutputTask task(1000, 100);
+    task.lastRun = ~0UL - 500;  // last run 500 ms before the wrap
+    task.nextRun = 499;         // next slow run 500 ms after the wrap
+    task.enableFast();
+    EXPECT_EQ(task.nextRun, ~0UL - 400);
+}
+
+// skip policy also applies to the fast interval, the tolerance is a quarter of the fast interval
+TEST(OutputTaskTest, SkipPolicyInFastMode) {
+    TestOutputTask task(1000, 100);
+    task.setMissedRunPolicy(MissedRunPolicy::skip);
+    task.enabledFast = true;
+    task.nextRun = 1000;
+    task.lastRun = 900;
+    EXPECT_TRUE(task.isRunScheduled(1220));
+    EXPECT_EQ(task.nextRun, 1300u);
+    EXPECT_EQ(task.lastRun, 1220u);
+    EXPECT_EQ(task.statistics.missedCycles, 2u);
+    EXPECT_FALSE(task.isRunScheduled(1350));
+    EXPECT_EQ(task.nextRun, 1400u);
+    EXPECT_EQ(task.lastRun, 1220u);
+    EXPECT_EQ(task.statistics.missedCycles, 3u);
+}
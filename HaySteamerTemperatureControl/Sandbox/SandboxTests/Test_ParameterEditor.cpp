@@ -85,6 +85,28 @@ TEST_F(ParameterEditorTest, SetCharacterProviderAndUpdate) {
     EXPECT_EQ(editor->getTimeMinutes(), 30);
 }
 
+// Tests update processes all pending keys in one call
+TEST_F(ParameterEditorTest, UpdateDrainsAllPendingKeys) {
+    std::string input = "A1530B45";
+    size_t idx = 0;
+    editor->setCharacterProvider([&]() {
+        if (idx < input.size()) return input[idx++];
+        return '\0';
+    });
+    editor->update();
+    EXPECT_EQ(editor->getTimeHours(), 15);
+    EXPECT_EQ(editor->getTimeMinutes(), 30);
+    EXPECT_EQ(editor->getTemperature(), 45);
+}
+
+// Tests update stops after maxKeysPerUpdate keys
+TEST_F(ParameterEditorTest, UpdateProcessesAtMostMaxKeys) {
+    int calls = 0;
+    editor->setCharacterProvider([&]() { ++calls; return '*'; });
+    editor->update();
+    EXPECT_EQ(calls, ParameterEditor::maxKeysPerUpdate);
+}
+
 // Tests update does nothing if provider returns '\0'
 TEST_F(ParameterEditorTest, UpdateWithNoInput) {
     editor->setCharacterProvider([]() { return '\0'; });
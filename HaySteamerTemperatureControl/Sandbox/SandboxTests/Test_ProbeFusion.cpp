@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "../../ProbeFusion.h"
+
+#include <initializer_list>
+
+namespace {
+    struct Samples {
+        ProbeSample probes[maxTempProbes];
+        uint8_t count = 0;
+
+        Samples(std::initializer_list<int> values) {
+            for (int value : values) {
+                probes[count].value = Temperature::fromCelsius(value);
+                probes[count].valid = true;
+                ++count;
+            }
+        }
+    };
+
+    FusionResult fuse(ProbeFusion<maxTempProbes>& fusion, const Samples& samples) {
+        return fusion.fuse(samples.probes, samples.count);
+    }
+}
+
+TEST(ProbeFusionTest, MinimumIsTheColdestProbe) {
+    ProbeFusion<maxTempProbes> fusion;
+    const FusionResult result = fuse(fusion, { 62, 58, 65, 60 });
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(result.value, 58_degC);
+    EXPECT_EQ(result.used, 4);
+    EXPECT_FALSE(result.disagreement);
+}
+
+TEST(ProbeFusionTest, MedianOfOddAndEvenCounts) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setMode(FusionMode::median);
+    EXPECT_EQ(fuse(fusion, { 62, 58, 65 }).value, 62_degC);
+    EXPECT_EQ(fuse(fusion, { 62, 58, 65, 60 }).value, 61_degC);
+}
+
+TEST(ProbeFusionTest, TrimmedMeanDropsTheExtremes) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setMode(FusionMode::trimmedMean);
+    // 50 and 70 are dropped, (58 + 60 + 62 + 64) / 4 = 61
+    EXPECT_EQ(fuse(fusion, { 50, 58, 60, 62, 64, 70 }).value, 61_degC);
+    // two probes are simply averaged, the mean keeps the fraction
+    EXPECT_EQ(fuse(fusion, { 59, 62 }).value, 60.5_degC);
+}
+
+TEST(ProbeFusionTest, OutlierIsRejectedAndReported) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setOutlierLimit(10_degC);
+    fusion.setMode(FusionMode::median);
+    // a shorted probe reads the ambient temperature
+    const FusionResult result = fuse(fusion, { 61, 20, 63, 60, 62 });
+    EXPECT_EQ(result.value, 61.5_degC);
+    EXPECT_EQ(result.used, 4);
+    EXPECT_EQ(result.rejected, 1);
+    EXPECT_TRUE(result.disagreement);
+}
+
+TEST(ProbeFusionTest, MinimumKeepsAColdSpot) {
+    ProbeFusion<maxTempProbes> fusion;
+    // the core of the bale is 30 C colder than the rest, it decides and is reported
+    FusionResult result = fuse(fusion, { 70, 72, 40, 71, 69 });
+    EXPECT_EQ(result.value, 40_degC);
+    EXPECT_EQ(result.used, 5);
+    EXPECT_EQ(result.rejected, 0);
+    EXPECT_TRUE(result.disagreement);
+    // a probe reading far too high is still rejected
+    result = fuse(fusion, { 60, 62, 61, 120 });
+    EXPECT_EQ(result.value, 60_degC);
+    EXPECT_EQ(result.used, 3);
+    EXPECT_EQ(result.rejected, 1);
+    EXPECT_TRUE(result.disagreement);
+}
+
+TEST(ProbeFusionTest, TwoProbesOnlyDisagree) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setOutlierLimit(10_degC);
+    const FusionResult result = fuse(fusion, { 61, 20 });
+    EXPECT_EQ(result.value, 20_degC);
+    EXPECT_EQ(result.rejected, 0);
+    EXPECT_TRUE(result.disagreement);
+}
+
+TEST(ProbeFusionTest, NoMajorityKeepsAllProbes) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setOutlierLimit(10_degC);
+    fusion.setMode(FusionMode::median);
+    const FusionResult result = fuse(fusion, { 20, 25, 70, 75 });
+    EXPECT_EQ(result.used, 4);
+    EXPECT_EQ(result.value, 47.5_degC);
+    EXPECT_TRUE(result.disagreement);
+}
+
+TEST(ProbeFusionTest, InvalidProbesAreLeftOut) {
+    ProbeFusion<maxTempProbes> fusion;
+    Samples samples{ 40, 60, 62 };
+    samples.probes[0].valid = false;
+    const FusionResult result = fusion.fuse(samples.probes, samples.count);
+    EXPECT_EQ(result.value, 60_degC);
+    EXPECT_EQ(result.used, 2);
+
+    samples.probes[1].valid = false;
+    samples.probes[2].valid = false;
+    EXPECT_FALSE(fusion.fuse(samples.probes, samples.count).valid);
+}
+
+TEST(ProbeFusionTest, ZeroLimitTurnsRejectionOff) {
+    ProbeFusion<maxTempProbes> fusion;
+    fusion.setOutlierLimit(0_degC);
+    const FusionResult result = fuse(fusion, { 61, 20, 63 });
+    EXPECT_EQ(result.value, 20_degC);
+    EXPECT_EQ(result.rejected, 0);
+    EXPECT_FALSE(result.disagreement);
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "../../ProbeSampler.h"
+
+#include <vector>
+
+namespace {
+    // two converters like the MAX6675, records when each one was accessed
+    struct FakeProbes {
+        static constexpr uint8_t probeCount = 2;
+        static constexpr unsigned long conversionTime_ms = 220;
+        static constexpr int countsPerDegree = 4;
+
+        int values[probeCount] = { 80, 80 };   // quarter degrees
+        bool open[probeCount] = { false, false };
+        std::vector<uint8_t> started;
+        std::vector<uint8_t> collected;
+
+        void startConversion(uint8_t probe) { started.push_back(probe); }
+
+        bool collect(uint8_t probe, int& value) {
+            collected.push_back(probe);
+            if (open[probe]) return false;
+            value = values[probe];
+            return true;
+        }
+    };
+}
+
+TEST(ProbeSamplerTest, StartsAllConversionsAndWaitsForThem) {
+    FakeProbes probes;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    EXPECT_FALSE(sampler.poll(0));
+    EXPECT_EQ(probes.started, (std::vector<uint8_t>{ 0, 1 }));
+    EXPECT_FALSE(sampler.poll(219));
+    EXPECT_TRUE(probes.collected.empty());
+    EXPECT_TRUE(sampler.poll(220));
+    EXPECT_EQ(probes.collected, (std::vector<uint8_t>{ 0 }));
+}
+
+TEST(ProbeSamplerTest, ProbesAreStaggered) {
+    FakeProbes probes;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    sampler.begin(0);
+    std::vector<unsigned long> times;
+    for (unsigned long now = 0; now <= 1000; now += 10) {
+        if (sampler.poll(now)) times.push_back(now);
+    }
+    EXPECT_EQ(times, (std::vector<unsigned long>{ 220, 330, 440, 550, 660, 770, 880, 990 }));
+    EXPECT_EQ(probes.collected, (std::vector<uint8_t>{ 0, 1, 0, 1, 0, 1, 0, 1 }));
+}
+
+TEST(ProbeSamplerTest, SlowPollsNeverCollectAProbeBeforeItsConversionIsDone) {
+    FakeProbes probes;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    sampler.begin(0);
+    unsigned long lastCollect[2] = { 0, 0 };
+    for (unsigned long now = 0; now <= 5000; now += 100) {
+        const size_t before = probes.collected.size();
+        sampler.poll(now);
+        ASSERT_LE(probes.collected.size(), before + 1) << "one probe per poll";
+        if (probes.collected.size() > before) {
+            const uint8_t probe = probes.collected.back();
+            EXPECT_GE(now - lastCollect[probe], 220u);
+            lastCollect[probe] = now;
+        }
+    }
+    EXPECT_GT(probes.collected.size(), 10u);
+}
+
+TEST(ProbeSamplerTest, ReadReturnsTheLowestCachedSampleWithoutAccessingTheProbes) {
+    FakeProbes probes;
+    probes.values[0] = 65 * 4;
+    probes.values[1] = 58 * 4 + 1;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    sampler.begin(0);
+    sampler.poll(220);
+    EXPECT_EQ(sampler.read(), 65_degC);
+    sampler.poll(330);
+    const size_t accesses = probes.collected.size();
+    EXPECT_EQ(sampler.read(), 58.25_degC);
+    EXPECT_EQ(probes.collected.size(), accesses);
+    EXPECT_EQ(sampler.getSample(0).timeStamp, 220u);
+    EXPECT_EQ(sampler.getSample(1).timeStamp, 330u);
+    EXPECT_EQ(sampler.getSampleTime(), 330u);
+}
+
+TEST(ProbeSamplerTest, OpenProbeIsLeftOut) {
+    FakeProbes probes;
+    probes.values[0] = 65 * 4;
+    probes.values[1] = 58 * 4;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    sampler.begin(0);
+    sampler.poll(220);
+    sampler.poll(330);
+    probes.open[1] = true;
+    sampler.poll(440);
+    sampler.poll(550);
+    EXPECT_FALSE(sampler.getSample(1).valid);
+    EXPECT_EQ(sampler.read(), 65_degC);
+
+    // no valid probe at all keeps the last value
+    probes.open[0] = true;
+    sampler.poll(660);
+    EXPECT_EQ(sampler.read(), 65_degC);
+}
+
+TEST(ProbeSamplerTest, KeepsRunningAcrossTimerWraparound) {
+    FakeProbes probes;
+    ProbeSampler<FakeProbes> sampler(&probes);
+    const unsigned long start = 0xFFFFFFFFUL - 250;
+    sampler.begin(start);
+    EXPECT_FALSE(sampler.poll(start + 200));
+    EXPECT_TRUE(sampler.poll(start + 220));
+    EXPECT_FALSE(sampler.poll(start + 300));
+    EXPECT_TRUE(sampler.poll(start + 330));
+}
@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+#include "../../ProcessImage.h"
+
+struct Pair {
+    int first;
+    int second;
+};
+
+TEST(DoubleBufferTest, ReadsLastWrittenValue) {
+    DoubleBuffer<Pair> buffer;
+    EXPECT_EQ(buffer.read().first, 0);
+    buffer.write({ 1, 2 });
+    buffer.write({ 3, 4 });
+    Pair value = buffer.read();
+    EXPECT_EQ(value.first, 3);
+    EXPECT_EQ(value.second, 4);
+    EXPECT_EQ(buffer.lastWritten().first, 3);
+}
+
+TEST(DoubleBufferTest, WriteDoesNotTouchThePublishedBuffer) {
+    DoubleBuffer<Pair> buffer;
+    buffer.write({ 1, 1 });
+    const Pair& published = buffer.lastWritten();
+    buffer.write({ 2, 2 });
+    // the previously published value stays intact in the other buffer until the next write
+    EXPECT_EQ(published.first, 1);
+    EXPECT_EQ(published.second, 1);
+}
+
+TEST(ProcessImageTest, TemperatureIsTheFusedValue) {
+    ProcessImage image;
+    image.temperature = 61_degC;
+    image.temperatures[0] = 70_degC;
+    image.temperatures[1] = 61_degC;
+    EXPECT_EQ(image.getTemperature(), 61_degC);
+    EXPECT_EQ(image.probeCount, 1);
+}
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include "../../SensorFilters.h"
+#include "../../ProbeSampler.h"
+
+#include <vector>
+
+namespace {
+    // feeds the values through a stage and returns its outputs
+    template<typename Policy>
+    std::vector<int> respond(const std::vector<int>& inputs) {
+        typename Policy::template Stage<int> stage;
+        std::vector<int> outputs;
+        for (int value : inputs) outputs.push_back(stage(value));
+        return outputs;
+    }
+
+    // replays values as a sensor
+    class ReplaySensor : public Sensor<int> {
+    public:
+        explicit ReplaySensor(std::vector<int> values) : values(std::move(values)) {}
+        int read() override { return values[next < values.size() - 1 ? next++ : next]; }
+    private:
+        std::vector<int> values;
+        size_t next = 0;
+    };
+}
+
+TEST(SensorFiltersTest, MedianStepResponse) {
+    // the step passes after half the window, a single spike is removed
+    EXPECT_EQ(respond<Median<5>>({ 20, 20, 20, 20, 20, 60, 60, 60, 60, 60 }),
+              (std::vector<int>{ 20, 20, 20, 20, 20, 20, 20, 60, 60, 60 }));
+    EXPECT_EQ(respond<Median<3>>({ 20, 20, 90, 20, 20 }),
+              (std::vector<int>{ 20, 20, 20, 20, 20 }));
+}
+
+TEST(SensorFiltersTest, MedianKeepsDuplicatesApart) {
+    EXPECT_EQ(respond<Median<3>>({ 5, 5, 7, 7, 3, 3, 3 }),
+              (std::vector<int>{ 5, 5, 5, 7, 7, 3, 3 }));
+}
+
+TEST(SensorFiltersTest, EmaStepResponse) {
+    // alpha 1/2 halves the distance with every value and reaches the step exactly
+    using Half = Ema<1, 2>;
+    EXPECT_EQ(respond<Half>({ 20, 100, 100, 100, 100, 100, 100, 100, 100, 100 }),
+              (std::vector<int>{ 20, 60, 80, 90, 95, 98, 99, 99, 100, 100 }));
+    using Slow = Ema<1, 8>;
+    const std::vector<int> slow = respond<Slow>(std::vector<int>(60, 60));
+    EXPECT_EQ(slow.back(), 60);
+}
+
+TEST(SensorFiltersTest, EmaSettlesOnSmallSteps) {
+    using Slow = Ema<1, 16>;
+    std::vector<int> inputs(1, 60);
+    inputs.resize(100, 61);
+    EXPECT_EQ(respond<Slow>(inputs).back(), 61);
+    inputs.assign(1, -10);
+    inputs.resize(100, -11);
+    EXPECT_EQ(respond<Slow>(inputs).back(), -11);
+}
+
+TEST(SensorFiltersTest, RateLimitStepResponse) {
+    EXPECT_EQ(respond<RateLimit<5>>({ 20, 40, 40, 40, 40, 10, 10 }),
+              (std::vector<int>{ 20, 25, 30, 35, 40, 35, 30 }));
+}
+
+TEST(SensorFiltersTest, DeadbandStepResponse) {
+    // toggling by one degree does not move the output, a step of two does
+    EXPECT_EQ(respond<Deadband<1>>({ 60, 61, 60, 59, 60, 62, 61, 63 }),
+              (std::vector<int>{ 60, 60, 60, 60, 60, 62, 62, 62 }));
+}
+
+TEST(SensorFiltersTest, StagesAreAppliedInOrder) {
+    ReplaySensor sensor({ 20, 20, 90, 20, 40, 40, 40, 40 });
+    Filtered<ReplaySensor, Median<3>, RateLimit<10>> filtered(&sensor);
+    std::vector<int> outputs;
+    for (int i = 0; i < 8; ++i) outputs.push_back(filtered.read());
+    EXPECT_EQ(outputs, (std::vector<int>{ 20, 20, 20, 20, 30, 40, 40, 40 }));
+    EXPECT_EQ(filtered.getRaw(), 40);
+}
+
+TEST(SensorFiltersTest, WithoutStagesTheReadingPasses) {
+    ReplaySensor sensor({ 20, 90 });
+    Filtered<ReplaySensor> filtered(&sensor);
+    EXPECT_EQ(filtered.read(), 20);
+    EXPECT_EQ(filtered.read(), 90);
+    static_assert(sizeof(Filtered<ReplaySensor>) <= sizeof(Filtered<ReplaySensor, Median<3>>), "no stage, no state");
+}
+
+TEST(SensorFiltersTest, ResetStartsTheFiltersOver) {
+    ReplaySensor sensor({ 20, 20, 80 });
+    Filtered<ReplaySensor, RateLimit<5>> filtered(&sensor);
+    filtered.read();
+    filtered.read();
+    filtered.reset();
+    EXPECT_EQ(filtered.read(), 80);
+}
+
+TEST(SensorFiltersTest, TemperaturesAreFilteredInHundredths) {
+    Ema<1, 2>::Stage<Temperature> ema;
+    EXPECT_EQ(ema(60_degC), 60_degC);
+    EXPECT_EQ(ema(61_degC), 60.5_degC);
+    Deadband<25>::Stage<Temperature> deadband;
+    EXPECT_EQ(deadband(60_degC), 60_degC);
+    EXPECT_EQ(deadband(60.25_degC), 60_degC);
+    EXPECT_EQ(deadband(60.5_degC), 60.5_degC);
+}
+
+TEST(SensorFiltersTest, SketchChainFollowsAStepWithinSeconds) {
+    // the chain of the sketch on 1 s samples: a 10 C step is half through after 2 samples
+    // and within a quarter degree after 7, which delays the drop fault by about 2 s and is nothing against the stall window
+    Median<3>::Stage<Temperature> median;
+    Ema<1, 2>::Stage<Temperature> ema;
+    std::vector<Temperature> outputs;
+    for (int second = 0; second < 5; ++second) ema(median(20_degC));
+    for (int second = 0; second < 8; ++second) outputs.push_back(ema(median(30_degC)));
+    EXPECT_EQ(outputs[0], 20_degC);
+    EXPECT_GE(outputs[1], 25_degC);
+    EXPECT_LT(outputs[5], 29.75_degC);
+    EXPECT_GE(outputs[6], 29.75_degC);
+    EXPECT_GE(outputs[7], 29.75_degC);
+}
+
+namespace {
+    struct OneProbe {
+        static constexpr uint8_t probeCount = 1;
+        static constexpr unsigned long conversionTime_ms = 220;
+        static constexpr int countsPerDegree = 1;
+        void startConversion(uint8_t) {}
+        bool collect(uint8_t, int& value) { value = 42; return true; }
+    };
+}
+
+TEST(SensorFiltersTest, ProbesArePassedThrough) {
+    OneProbe probe;
+    ProbeSampler<OneProbe> sampler(&probe);
+    Filtered<ProbeSampler<OneProbe>, Ema<1, 4>> filtered(&sampler);
+    sampler.poll(0);
+    sampler.poll(220);
+    EXPECT_EQ(filtered.read(), 42_degC);
+    EXPECT_EQ(filtered.getProbeCount(), 1);
+    EXPECT_EQ(filtered.getSample(0).value, 42_degC);
+    EXPECT_TRUE(filtered.getFusionResult().valid);
+}
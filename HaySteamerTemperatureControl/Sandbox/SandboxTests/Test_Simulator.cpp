@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+#include "../../TaskScheduler.h"
+#include "../Simulator.h"
+#include "../SimulatedPlant.h"
+
+#include <chrono>
+
+namespace {
+    // 2025-10-01 11:00:00 local time
+    const time_t startOfSimulation = 1759316400;
+    const unsigned long minute = 60000;
+    const unsigned long hour = 60 * minute;
+}
+
+class SimulatorTest : public ::testing::Test {
+protected:
+    SimulatedClock clock{ startOfSimulation };
+    SimulatedHayBale bale;
+    SimulatedKeypad keypad;
+    SimulatedDisplay display;
+    SimulatedRelay relay{ bale };
+    SimulatedLED led;
+    CyclicCaller caller{ &clock, &bale, &keypad, &display, &relay, &led };
+
+    void SetUp() override
+    {
+        keypad.setInterruptHandler([this] { caller.onKeyChanged(millis()); });
+    }
+
+    void pressStartButton(Simulator<CyclicCaller>& sim)
+    {
+        caller.setStartButton(true);
+        // hold the button for one logic cycle
+        sim.after(2500, [this] { caller.setStartButton(false); });
+    }
+};
+
+TEST_F(SimulatorTest, VirtualClockStartsAtGivenTime) {
+    Simulator<CyclicCaller> sim(caller, 5000);
+    EXPECT_EQ(sim.now(), 5000u);
+    EXPECT_EQ(millis(), 5000u);
+    EXPECT_EQ(caller.nextDeadline(), 5100u);
+}
+
+TEST_F(SimulatorTest, JumpsFromDeadlineToDeadline) {
+    Simulator<CyclicCaller> sim(caller);
+    sim.runFor(10000);
+    EXPECT_EQ(sim.now(), 10000u);
+    // one pass per fast input deadline, every 100 ms
+    EXPECT_EQ(sim.getPassCount(), 100u);
+    EXPECT_EQ(caller.getTaskStatistics(1).runCount, 100u);
+    EXPECT_EQ(caller.getTaskStatistics(0).runCount, 10u);
+    EXPECT_EQ(caller.getTaskStatistics(2).runCount, 5u);
+    EXPECT_EQ(caller.getTaskStatistics(3).runCount, 10u);
+    // tasks always start on time in virtual time
+    EXPECT_EQ(caller.getTaskStatistics(1).latenessHistogram[0], 100u);
+}
+
+TEST_F(SimulatorTest, ScriptedEventsRunInTimeOrder) {
+    Simulator<CyclicCaller> sim(caller);
+    std::vector<unsigned long> fired;
+    sim.at(2500, [&] { fired.push_back(sim.now()); });
+    sim.at(1234, [&] { fired.push_back(sim.now()); });
+    sim.at(1234, [&] { fired.push_back(sim.now()); });
+    sim.runFor(3000);
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[0], 1234u);
+    EXPECT_EQ(fired[1], 1234u);
+    EXPECT_EQ(fired[2], 2500u);
+    EXPECT_EQ(sim.getEventCount(), 3u);
+}
+
+TEST_F(SimulatorTest, CrossesTheMillisWraparound) {
+    const unsigned long start = ~0UL - 4999;     // 5 s before the wrap
+    Simulator<CyclicCaller> sim(caller, start);
+    std::vector<unsigned long> fired;
+    sim.at(start + 7000, [&] { fired.push_back(sim.now()); });   // after the wrap
+    sim.at(start + 3000, [&] { fired.push_back(sim.now()); });   // before the wrap
+    sim.runFor(10000);
+    EXPECT_EQ(sim.now(), start + 10000);
+    // one pass per fast input deadline, like without the wrap
+    EXPECT_EQ(sim.getPassCount(), 100u);
+    ASSERT_EQ(fired.size(), 2u);
+    EXPECT_EQ(fired[0], start + 3000);
+    EXPECT_EQ(fired[1], start + 7000);
+}
+
+TEST_F(SimulatorTest, RunUntilConditionStopsWhenConditionIsMet) {
+    Simulator<CyclicCaller> sim(caller);
+    pressStartButton(sim);
+    EXPECT_TRUE(sim.runUntil([&] { return led.current() == Status::ready; }, minute));
+    EXPECT_LE(sim.now(), 3000u);
+    EXPECT_FALSE(sim.runUntil([&] { return led.current() == Status::done; }, minute));
+}
+
+TEST_F(SimulatorTest, FullSteamingCycleInVirtualTime) {
+    auto hostStart = std::chrono::steady_clock::now();
+    Simulator<CyclicCaller> sim(caller);
+
+    // set 60 C and 30 min at the keypad, start time is 12:00 by default
+    sim.at(1000, [&] { keypad.type("B60C30"); });
+    sim.at(5000, [&] { pressStartButton(sim); });
+
+    sim.runFor(5 * hour);
+
+    // idle -> ready -> heating -> holding -> done -> idle
+    std::vector<Status> expected{ Status::idle, Status::ready, Status::heating, Status::holding, Status::done, Status::idle };
+    ASSERT_EQ(led.changes.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(led.changes[i].status, expected[i]);
+    }
+
+    // heating starts at 12:00, one hour after the start of the simulation
+    EXPECT_NEAR(static_cast<double>(led.changes[2].timeStamp), static_cast<double>(hour), 3000.0);
+    // holding for 30 minutes, signal done for an hour
+    EXPECT_NEAR(static_cast<double>(led.changes[4].timeStamp - led.changes[3].timeStamp), 30.0 * minute, 2.0 * minute);
+    EXPECT_NEAR(static_cast<double>(led.changes[5].timeStamp - led.changes[4].timeStamp), 60.0 * minute, 2.0 * minute);
+    EXPECT_EQ(relay.switchCount, 2u);
+    EXPECT_EQ(display.lines[1], "idle");
+    // the display is only written when time (minutes), status, temperature or parameters changed,
+    // the temperature in quarter degree steps while the bale heats up and cools down
+    EXPECT_LT(display.writeCount, 5u * 60u + 500u);
+
+    // one sample per second, rolled up into 5 minute and hourly entries
+    const TemperatureHistory& history = caller.getHistory();
+    EXPECT_EQ(history.recent().size(), 600u);
+    EXPECT_EQ(history.day().size(), 60u);
+    EXPECT_EQ(history.week().size(), 5u);
+    Temperature hottest;
+    for (const HistoryPoint& point : history.day().query(hour, 3 * hour)) {
+        if (point.maximum > hottest) hottest = point.maximum;
+    }
+    EXPECT_GE(hottest, 60_degC);
+
+    auto hostTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - hostStart);
+    RecordProperty("host_time_ms", static_cast<int>(hostTime.count()));
+}
+
+TEST_F(SimulatorTest, FastTypingLosesNoKeys) {
+    Simulator<CyclicCaller> sim(caller);
+    // five keys within 100 ms, one fast input period
+    const char* keys = "A0815";
+    for (int i = 0; keys[i]; ++i) {
+        char key = keys[i];
+        sim.at(1010 + 20 * i, [this, key] { keypad.press(key); });
+    }
+    sim.runFor(3000);
+    EXPECT_EQ(display.lines[3], "08:15, 20C, 30min");
+}
+
+TEST_F(SimulatorTest, KeyEchoUsesFastOutputForAWhile) {
+    Simulator<CyclicCaller> sim(caller);
+    caller.setFastOutputWindow(5000);
+    sim.runFor(10000);
+    unsigned long writesBeforeEdit = display.writeCount;
+    EXPECT_FALSE(caller.isFastOutputActive());
+
+    sim.at(10550, [this] { keypad.press('A'); });
+    sim.runUntil(10560);
+    // the edit is shown right away, not with the next regular output run at 11000
+    EXPECT_GT(display.writeCount, writesBeforeEdit);
+    EXPECT_EQ(display.lines[3], "__:__, 20C, 30min");
+    EXPECT_TRUE(caller.isFastOutputActive());
+    ASSERT_EQ(caller.getKeyEchoLatency().count, 1u);
+    EXPECT_LT(caller.getKeyEchoLatency().max, 100u);
+
+    sim.runUntil(15700);
+    EXPECT_FALSE(caller.isFastOutputActive());
+}
+
+namespace {
+    using ConcreteCyclicCaller = BasicCyclicCaller<SimulatedClock, SimulatedHayBale, SimulatedKeypad,
+        SimulatedDisplay, SimulatedRelay, SimulatedLED>;
+
+    // runs a steaming cycle with the given caller type and returns the recorded status changes
+    template<typename Caller>
+    std::vector<SimulatedLED::Change> runSteamingCycle()
+    {
+        SimulatedClock clock{ startOfSimulation };
+        SimulatedHayBale bale;
+        SimulatedKeypad keypad;
+        SimulatedDisplay display;
+        SimulatedRelay relay{ bale };
+        SimulatedLED led;
+        Caller caller{ &clock, &bale, &keypad, &display, &relay, &led };
+        keypad.setInterruptHandler([&] { caller.onKeyChanged(millis()); });
+
+        Simulator<Caller> sim(caller);
+        sim.at(1000, [&] { keypad.type("B60C30"); });
+        sim.at(5000, [&] { caller.setStartButton(true); });
+        sim.at(7500, [&] { caller.setStartButton(false); });
+        sim.runFor(5 * hour);
+        return led.changes;
+    }
+}
+
+TEST(SimulatorConcreteCallerTest, ConcreteHardwareTypesBehaveLikeInterfaces) {
+    auto polymorphic = runSteamingCycle<CyclicCaller>();
+    auto concrete = runSteamingCycle<ConcreteCyclicCaller>();
+    ASSERT_EQ(concrete.size(), polymorphic.size());
+    ASSERT_EQ(concrete.size(), 6u);
+    for (size_t i = 0; i < concrete.size(); ++i) {
+        EXPECT_EQ(concrete[i].status, polymorphic[i].status);
+        EXPECT_EQ(concrete[i].timeStamp, polymorphic[i].timeStamp);
+    }
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "../../SpscQueue.h"
+
+TEST(SpscQueueTest, EmptyQueue) {
+    SpscQueue<int, 4> queue;
+    int item = 7;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.capacity(), 3u);
+    EXPECT_FALSE(queue.pop(item));
+    EXPECT_EQ(item, 7);
+}
+
+TEST(SpscQueueTest, PopsInPushOrder) {
+    SpscQueue<int, 4> queue;
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    EXPECT_EQ(queue.size(), 3u);
+    int item = 0;
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, 2);
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, 3);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, FullQueueDropsNewItems) {
+    SpscQueue<int, 4> queue;
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_EQ(queue.getDropped(), 1u);
+    int item = 0;
+    queue.pop(item);
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.push(5));
+}
+
+TEST(SpscQueueTest, IndicesWrapAround) {
+    SpscQueue<int, 4> queue;
+    int item = 0;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(queue.push(i));
+        EXPECT_TRUE(queue.push(i + 1000));
+        EXPECT_TRUE(queue.pop(item));
+        EXPECT_EQ(item, i);
+        EXPECT_TRUE(queue.pop(item));
+        EXPECT_EQ(item, i + 1000);
+    }
+    EXPECT_TRUE(queue.empty());
+}
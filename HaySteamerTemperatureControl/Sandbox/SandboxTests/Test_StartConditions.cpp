@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "../../StartConditions.h"
+#include "../millis.h"
 
 // Test fixture for StartConditions
 class StartConditionsTest : public ::testing::Test {
@@ -16,6 +17,20 @@ TEST_F(StartConditionsTest, TimerConditionFalse) {
     EXPECT_FALSE(conditions.timerCondition());
 }
 
+// Test: timerCondition returns true after a start time shortly before midnight
+TEST_F(StartConditionsTest, TimerConditionAcrossMidnight) {
+    unsigned long time = 5;      // 00:05
+    unsigned long start = 1430;  // 23:50
+    conditions.setGetTimeOfDayInMinutes([&] { return time; });
+    conditions.setGetStartTimeInMinutes([&] { return start; });
+    EXPECT_TRUE(conditions.timerCondition());
+    // the window ends 12 hours after the start
+    time = 1430 + 720 - 1440;
+    EXPECT_FALSE(conditions.timerCondition());
+    conditions.setTimerWindow(721);
+    EXPECT_TRUE(conditions.timerCondition());
+}
+
 // Test: timerCondition returns true if time >= start
 TEST_F(StartConditionsTest, TimerConditionTrue) {
     int time = 300;
@@ -80,4 +95,119 @@ TEST_F(StartConditionsTest, MultipleTrueConditionsReturnsTrue) {
     conditions.addCondition([] { return true; });
     conditions.addCondition([] { return true; });
     EXPECT_TRUE(conditions.checkAllConditions());
-}
\ No newline at end of file
+}
+// Test: conditions beyond the capacity are rejected
+TEST_F(StartConditionsTest, AddConditionFailsWhenFull) {
+    for (size_t i = 0; i < StartConditions::maxConditions; ++i) {
+        EXPECT_TRUE(conditions.addCondition([] { return false; }));
+    }
+    EXPECT_FALSE(conditions.addCondition([] { return true; }));
+    EXPECT_FALSE(conditions.checkAllConditions());
+}
+
+// Test: evaluation stops at the first condition met
+TEST_F(StartConditionsTest, StopsAtFirstTrueCondition) {
+    int laterCalls = 0;
+    conditions.addCondition([] { return true; });
+    conditions.addCondition([&] { ++laterCalls; return true; });
+    EXPECT_TRUE(conditions.checkAllConditions());
+    EXPECT_EQ(laterCalls, 0);
+}
+
+// Test: cheaper conditions move to the front
+TEST_F(StartConditionsTest, CheapConditionsAreCheckedFirst) {
+    SandboxClock::useVirtualTime = true;
+    int order = 0;
+    int expensiveRun = 0;
+    int cheapRun = 0;
+    conditions.addCondition([&] { SandboxClock::virtualMillis += 2; expensiveRun = ++order; return false; });
+    conditions.addCondition([&] { cheapRun = ++order; return false; });
+    conditions.checkAllConditions();
+    EXPECT_LT(expensiveRun, cheapRun);
+    conditions.checkAllConditions();
+    EXPECT_LT(cheapRun, expensiveRun);
+    EXPECT_EQ(conditions.getCost(0), 0u);
+    EXPECT_EQ(conditions.getCost(1), 2000u);
+    SandboxClock::useVirtualTime = false;
+}
+
+// Test: edge triggered conditions are only evaluated when their input changed
+TEST_F(StartConditionsTest, EdgeTriggeredConditionRunsOnInputChange) {
+    ChangeCounter remoteCommand;
+    bool requested = false;
+    int calls = 0;
+    EXPECT_TRUE(conditions.addEdgeTriggeredCondition([&] { ++calls; return requested; }, remoteCommand));
+    EXPECT_FALSE(conditions.checkAllConditions());
+    EXPECT_FALSE(conditions.checkAllConditions());
+    EXPECT_EQ(calls, 1);
+
+    requested = true;
+    remoteCommand.markChanged();
+    EXPECT_TRUE(conditions.checkAllConditions());
+    // the edge is consumed, a stale true does not start the process again
+    EXPECT_FALSE(conditions.checkAllConditions());
+    EXPECT_EQ(calls, 2);
+
+    // a source that stays true reports it again with its next change
+    remoteCommand.markChanged();
+    EXPECT_TRUE(conditions.checkAllConditions());
+    EXPECT_EQ(calls, 3);
+}
+
+// Test: an edge met while an earlier condition is met stays pending for a later check
+TEST_F(StartConditionsTest, EdgeIsKeptWhileAnEarlierConditionIsMet) {
+    ChangeCounter remoteCommand;
+    bool first = true;
+    conditions.addCondition([&] { return first; }, 1);
+    conditions.addEdgeTriggeredCondition([] { return true; }, remoteCommand, 2);
+    remoteCommand.markChanged();
+    EXPECT_TRUE(conditions.checkAllConditions());
+    first = false;
+    EXPECT_TRUE(conditions.checkAllConditions());
+    EXPECT_FALSE(conditions.checkAllConditions());
+}
+
+// Test: declared costs order the conditions without measuring them
+TEST_F(StartConditionsTest, DeclaredCostsOrderTheConditions) {
+    SandboxClock::useVirtualTime = true;
+    int order = 0;
+    int expensiveRun = 0;
+    int cheapRun = 0;
+    conditions.addCondition([&] { SandboxClock::virtualMillis += 2; expensiveRun = ++order; return false; }, 5);
+    conditions.addCondition([&] { cheapRun = ++order; return false; }, 50);
+    conditions.checkAllConditions();
+    conditions.checkAllConditions();
+    EXPECT_LT(expensiveRun, cheapRun);
+    EXPECT_EQ(conditions.getCost(0), 5u);
+    EXPECT_EQ(conditions.getCost(1), 50u);
+    SandboxClock::useVirtualTime = false;
+}
+
+// Test: the run time is only sampled every costSampleInterval evaluations
+TEST_F(StartConditionsTest, RunTimeIsSampledNotMeasuredOnEveryCheck) {
+    SandboxClock::useVirtualTime = true;
+    unsigned long runTime = 1;
+    conditions.addCondition([&] { SandboxClock::virtualMillis += runTime; return false; });
+    conditions.checkAllConditions();
+    EXPECT_EQ(conditions.getCost(0), 1000u);
+    runTime = 5;
+    for (int i = 1; i < StartConditions::costSampleInterval; ++i) {
+        conditions.checkAllConditions();
+    }
+    EXPECT_EQ(conditions.getCost(0), 1000u);
+    conditions.checkAllConditions();
+    EXPECT_EQ(conditions.getCost(0), 2000u);
+    SandboxClock::useVirtualTime = false;
+}
+
+// Test: the timer condition is only computed again when time or start time changed
+TEST_F(StartConditionsTest, TimerConditionIsCached) {
+    int reads = 0;
+    unsigned long time = 300;
+    conditions.setGetTimeOfDayInMinutes([&] { ++reads; return time; });
+    conditions.setGetStartTimeInMinutes([] { return 200; });
+    EXPECT_TRUE(conditions.timerCondition());
+    time = 100;
+    EXPECT_FALSE(conditions.timerCondition());
+    EXPECT_EQ(reads, 2);
+}
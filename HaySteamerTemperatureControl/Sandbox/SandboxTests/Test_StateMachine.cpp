@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "../../StateMachine.h"
 
+#include <string>
+#include <vector>
+
 TEST(HaySteamerStateMachineTest, InitialStatusIsIdle) {
     HaySteamerStateMachine sm;
     EXPECT_EQ(sm.getCurrentStatus(), Status::idle);
@@ -57,3 +60,53 @@ TEST(HaySteamerStateMachineTest, NoStatusChangeDoesNothing) {
     sm.changeStatus(Status::idle);
     EXPECT_EQ(sm.getCurrentStatus(), Status::idle);
 }
+
+TEST(HaySteamerStateMachineTest, TransitionTableMatchesTheProcess) {
+    static_assert(HaySteamerStateMachine::isTransitionAllowed(Status::idle, Status::heating), "idle -> heating");
+    static_assert(!HaySteamerStateMachine::isTransitionAllowed(Status::ready, Status::done), "ready -> done");
+    for (size_t from = 0; from < HaySteamerStateMachine::statusCount; ++from) {
+        EXPECT_EQ(HaySteamerStateMachine::isTransitionAllowed(static_cast<Status>(from), Status::error),
+            static_cast<Status>(from) != Status::error);
+    }
+    EXPECT_TRUE(HaySteamerStateMachine::isTransitionAllowed(Status::error, Status::idle));
+    EXPECT_FALSE(HaySteamerStateMachine::isTransitionAllowed(Status::error, Status::ready));
+}
+
+TEST(HaySteamerStateMachineTest, HooksAreCalledOnExitAndEntry) {
+    HaySteamerStateMachine sm;
+    std::vector<std::string> calls;
+    sm.setOnExit(Status::idle, [&calls](Status next) { calls.push_back("exit idle to " + std::to_string(static_cast<int>(next))); });
+    sm.setOnEntry(Status::ready, [&calls](Status previous) { calls.push_back("enter ready from " + std::to_string(static_cast<int>(previous))); });
+    sm.changeStatus(Status::ready);
+    ASSERT_EQ(calls.size(), 2u);
+    EXPECT_EQ(calls[0], "exit idle to 1");
+    EXPECT_EQ(calls[1], "enter ready from 0");
+
+    // no hooks without a change
+    sm.changeStatus(Status::ready);
+    EXPECT_EQ(calls.size(), 2u);
+}
+
+TEST(HaySteamerStateMachineTest, InvalidTransitionEntersError) {
+    HaySteamerStateMachine sm;
+    Status entered = Status::idle;
+    sm.setOnEntry(Status::error, [&entered](Status previous) { entered = previous; });
+    sm.changeStatus(Status::holding); // Not allowed: idle -> holding
+    EXPECT_EQ(sm.getCurrentStatus(), Status::error);
+    EXPECT_EQ(entered, Status::idle);
+    EXPECT_EQ(sm.getTransitionCount(Status::idle, Status::error), 1u);
+    EXPECT_EQ(sm.getTransitionCount(Status::idle, Status::holding), 0u);
+}
+
+TEST(HaySteamerStateMachineTest, TransitionsAreCountedPerEdge) {
+    HaySteamerStateMachine sm;
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        sm.changeStatus(Status::heating);
+        sm.changeStatus(Status::holding);
+        sm.changeStatus(Status::done);
+        sm.changeStatus(Status::idle);
+    }
+    EXPECT_EQ(sm.getTransitionCount(Status::idle, Status::heating), 3u);
+    EXPECT_EQ(sm.getTransitionCount(Status::done, Status::idle), 3u);
+    EXPECT_EQ(sm.getTransitionCount(Status::idle, Status::ready), 0u);
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "../../StaticVector.h"
+
+#include <string>
+
+TEST(StaticVectorTest, EmptyVector) {
+    StaticVector<int, 3> vector;
+    EXPECT_TRUE(vector.empty());
+    EXPECT_FALSE(vector.full());
+    EXPECT_EQ(vector.size(), 0u);
+    EXPECT_EQ(vector.capacity(), 3u);
+    EXPECT_EQ(vector.begin(), vector.end());
+}
+
+TEST(StaticVectorTest, PushBackUntilFull) {
+    StaticVector<int, 3> vector;
+    EXPECT_TRUE(vector.push_back(1));
+    EXPECT_TRUE(vector.push_back(2));
+    EXPECT_TRUE(vector.push_back(3));
+    EXPECT_TRUE(vector.full());
+    EXPECT_FALSE(vector.push_back(4));
+    EXPECT_EQ(vector.size(), 3u);
+    EXPECT_EQ(vector[0], 1);
+    EXPECT_EQ(vector[2], 3);
+}
+
+TEST(StaticVectorTest, IteratesInInsertionOrder) {
+    StaticVector<std::string, 4> vector;
+    vector.push_back("a");
+    vector.push_back("b");
+    vector.push_back("c");
+    std::string joined;
+    for (const auto& item : vector) {
+        joined += item;
+    }
+    EXPECT_EQ(joined, "abc");
+}
+
+TEST(StaticVectorTest, AssignReplacesContent) {
+    StaticVector<int, 4> vector;
+    vector.push_back(7);
+    vector.assign(1, 2);
+    EXPECT_EQ(vector.size(), 2u);
+    EXPECT_EQ(vector[0], 1);
+    EXPECT_EQ(vector[1], 2);
+    vector.assign();
+    EXPECT_TRUE(vector.empty());
+}
+
+TEST(StaticVectorTest, ClearReleasesElements) {
+    StaticVector<std::string, 2> vector;
+    vector.push_back("x");
+    vector.clear();
+    EXPECT_TRUE(vector.empty());
+    EXPECT_TRUE(vector.push_back("y"));
+    EXPECT_EQ(vector[0], "y");
+}
+
+TEST(StaticVectorTest, StorageIsInsideTheObject) {
+    EXPECT_EQ(sizeof(StaticVector<void*, 4>), 4 * sizeof(void*) + sizeof(size_t));
+}
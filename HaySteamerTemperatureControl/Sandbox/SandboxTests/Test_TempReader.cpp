@@ -1,12 +1,13 @@
 ﻿#include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "../../TempReader.h"
+#include "../../ProbeSampler.h"
 #include "../Sensor.h"
 
 // Mock Sensor implementation
-class MockSensor : public Sensor<int> {
+class MockSensor : public Sensor<Temperature> {
 public:
-    MOCK_METHOD(int, read, (), (override));
+    MOCK_METHOD(Temperature, read, (), (override));
 };
 
 using ::testing::Return;
@@ -16,8 +17,8 @@ TEST(TempReaderTest, ReturnsInitialValueBeforeUpdate) {
     TempReader reader(&mockSensor);
 
     // Before update, lastValue should be 0
-    EXPECT_EQ(reader.getLatestValue(), 0);
-    EXPECT_EQ(reader.getDisplayString(), "  0C");
+    EXPECT_EQ(reader.getLatestValue(), 0_degC);
+    EXPECT_EQ(reader.getDisplayString(), "  0.0C");
 }
 
 TEST(TempReaderTest, UpdatesValueFromSensor) {
@@ -25,11 +26,11 @@ TEST(TempReaderTest, UpdatesValueFromSensor) {
     TempReader reader(&mockSensor);
 
     EXPECT_CALL(mockSensor, read())
-        .WillOnce(Return(23));
+        .WillOnce(Return(23_degC));
 
     reader.update();
-    EXPECT_EQ(reader.getLatestValue(), 23);
-    EXPECT_EQ(reader.getDisplayString(), " 23C");
+    EXPECT_EQ(reader.getLatestValue(), 23_degC);
+    EXPECT_EQ(reader.getDisplayString(), " 23.0C");
 }
 
 TEST(TempReaderTest, UpdatesValueMultipleTimes) {
@@ -37,14 +38,145 @@ TEST(TempReaderTest, UpdatesValueMultipleTimes) {
     TempReader reader(&mockSensor);
 
     EXPECT_CALL(mockSensor, read())
-        .WillOnce(Return(15))
-        .WillOnce(Return(-5));
+        .WillOnce(Return(15_degC))
+        .WillOnce(Return(-5_degC));
 
     reader.update();
-    EXPECT_EQ(reader.getLatestValue(), 15);
-    EXPECT_EQ(reader.getDisplayString(), " 15C");
+    EXPECT_EQ(reader.getLatestValue(), 15_degC);
+    EXPECT_EQ(reader.getDisplayString(), " 15.0C");
 
     reader.update();
-    EXPECT_EQ(reader.getLatestValue(), -5);
-    EXPECT_EQ(reader.getDisplayString(), " -5C");
-}
\ No newline at end of file
+    EXPECT_EQ(reader.getLatestValue(), -5_degC);
+    EXPECT_EQ(reader.getDisplayString(), " -5.0C");
+}
+TEST(TempReaderTest, PlainSensorIsOneProbe) {
+    MockSensor mockSensor;
+    TempReader reader(&mockSensor);
+    EXPECT_CALL(mockSensor, read()).WillOnce(Return(42_degC));
+    reader.update();
+    EXPECT_EQ(reader.getProbeCount(), 1);
+    EXPECT_EQ(reader.getProbe(0).value, 42_degC);
+    EXPECT_FALSE(reader.probesDisagree());
+}
+
+// sensor with probes, like ProbeSampler
+class FakeProbeSensor : public Sensor<Temperature> {
+public:
+    static constexpr uint8_t probeCount = 3;
+    ProbeSample samples[probeCount];
+    FusionResult fused;
+
+    Temperature read() override { return fused.value; }
+    uint8_t getProbeCount() const { return probeCount; }
+    const ProbeSample& getSample(uint8_t probe) const { return samples[probe]; }
+    const FusionResult& getFusionResult() const { return fused; }
+    unsigned long getConversionTime() const { return 220; }
+};
+
+TEST(TempReaderTest, HandsOutEveryProbe) {
+    FakeProbeSensor sensor;
+    BasicTempReader<FakeProbeSensor> reader(&sensor);
+    sensor.samples[0] = ProbeSample{ 58_degC, 100, true };
+    sensor.samples[1] = ProbeSample{ 61.25_degC, 210, true };
+    sensor.samples[2] = ProbeSample{ 20_degC, 320, false };
+    sensor.fused.value = 58_degC;
+    sensor.fused.disagreement = true;
+    reader.update();
+    EXPECT_EQ(reader.getLatestValue(), 58_degC);
+    ASSERT_EQ(reader.getProbeCount(), 3);
+    EXPECT_EQ(reader.getProbe(1).value, 61.25_degC);
+    EXPECT_EQ(reader.getProbe(1).timeStamp, 210u);
+    EXPECT_FALSE(reader.getProbe(2).valid);
+    EXPECT_TRUE(reader.probesDisagree());
+    // the oldest valid sample
+    EXPECT_EQ(reader.getSampleTime(), 100u);
+}
+
+TEST(TempReaderTest, SampleTimeOfAPlainSensorIsTheStartOfTheRead) {
+    SandboxClock::useVirtualTime = true;
+    SandboxClock::virtualMillis = 5000;
+    MockSensor mockSensor;
+    TempReader reader(&mockSensor);
+    EXPECT_CALL(mockSensor, read()).WillOnce([] { SandboxClock::virtualMillis += 30; return 42_degC; });
+    reader.update();
+    EXPECT_EQ(reader.getSampleTime(), 5000u);
+    EXPECT_EQ(reader.getProbe(0).timeStamp, 5000u);
+    SandboxClock::useVirtualTime = false;
+}
+
+TEST(TempReaderTest, ProbesWithoutValidSampleKeepTheSampleTime) {
+    FakeProbeSensor sensor;
+    BasicTempReader<FakeProbeSensor> reader(&sensor);
+    sensor.samples[1] = ProbeSample{ 58_degC, 400, true };
+    reader.update();
+    EXPECT_EQ(reader.getSampleTime(), 400u);
+    sensor.samples[1].valid = false;
+    reader.update();
+    EXPECT_EQ(reader.getSampleTime(), 400u);
+}
+
+TEST(TempReaderTest, OpenAndStaleProbesHaveFailed) {
+    SandboxClock::useVirtualTime = true;
+    SandboxClock::virtualMillis = 10000;
+    FakeProbeSensor sensor;
+    BasicTempReader<FakeProbeSensor> reader(&sensor);
+    sensor.samples[0] = ProbeSample{ 58_degC, 9800, true };
+    sensor.samples[1] = ProbeSample{ 59_degC, 9900, false };   // open thermocouple
+    sensor.samples[2] = ProbeSample{ 60_degC, 7799, true };    // not collected for more than 10 conversions
+    reader.update();
+    EXPECT_EQ(reader.getFailedProbes(), 0b110);
+    sensor.samples[2].timeStamp = 7800;
+    reader.update();
+    EXPECT_EQ(reader.getFailedProbes(), 0b010);
+
+    // a plain sensor never fails
+    MockSensor mockSensor;
+    TempReader plain(&mockSensor);
+    EXPECT_CALL(mockSensor, read()).WillOnce(Return(42_degC));
+    plain.update();
+    EXPECT_EQ(plain.getFailedProbes(), 0);
+    SandboxClock::useVirtualTime = false;
+}
+
+namespace {
+    // two probes whose thermocouples can be opened
+    struct OpenableProbes {
+        static constexpr uint8_t probeCount = 2;
+        static constexpr unsigned long conversionTime_ms = 220;
+        static constexpr int countsPerDegree = 4;
+        bool open[probeCount] = {};
+        void startConversion(uint8_t) {}
+        bool collect(uint8_t probe, int& counts) { counts = (60 + probe * 10) * countsPerDegree; return !open[probe]; }
+    };
+}
+
+TEST(TempReaderTest, OneProbeAndThenAllProbesGoOpen) {
+    SandboxClock::useVirtualTime = true;
+    SandboxClock::virtualMillis = 0;
+    OpenableProbes hardware;
+    ProbeSampler<OpenableProbes> sampler(&hardware);
+    BasicTempReader<ProbeSampler<OpenableProbes>> reader(&sampler);
+    auto run = [&](unsigned long duration) {
+        for (unsigned long end = SandboxClock::virtualMillis + duration; SandboxClock::virtualMillis < end; SandboxClock::virtualMillis += 10) {
+            sampler.poll(SandboxClock::virtualMillis);
+        }
+        reader.update();
+    };
+
+    run(1000);
+    EXPECT_EQ(reader.getFailedProbes(), 0);
+    EXPECT_EQ(reader.getLatestValue(), 60_degC);
+
+    // the cold probe goes open: the warmer one would become the minimum, the failure shows it
+    hardware.open[0] = true;
+    run(1000);
+    EXPECT_EQ(reader.getFailedProbes(), 0b01);
+    EXPECT_EQ(reader.getLatestValue(), 70_degC);
+
+    // with all probes open the value is frozen, the failure is the only sign of it
+    hardware.open[1] = true;
+    run(1000);
+    EXPECT_EQ(reader.getFailedProbes(), 0b11);
+    EXPECT_EQ(reader.getLatestValue(), 70_degC);
+    SandboxClock::useVirtualTime = false;
+}
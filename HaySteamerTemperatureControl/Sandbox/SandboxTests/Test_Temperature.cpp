@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include "../../Temperature.h"
+
+#include <string>
+
+namespace {
+    std::string formatted(Temperature temperature) {
+        char text[Temperature::displayLength + 1];
+        temperature.format(text);
+        return text;
+    }
+}
+
+TEST(TemperatureTest, KeepsHundredths) {
+    static_assert((60.25_degC).centiCelsius() == 6025, "literal in hundredths");
+    static_assert(Temperature::fromCounts(241, 4) == 60.25_degC, "quarter degrees of the MAX6675");
+    EXPECT_EQ(Temperature::fromCelsius(-5).centiCelsius(), -500);
+    EXPECT_EQ((-0.75_degC).centiCelsius(), -75);
+}
+
+TEST(TemperatureTest, Arithmetic) {
+    EXPECT_EQ(60_degC + 0.25_degC, 60.25_degC);
+    EXPECT_EQ(60_degC - 5_degC, 55_degC);
+    EXPECT_EQ(-(2_degC), Temperature::fromCelsius(-2));
+    EXPECT_EQ(1.5_degC * 3, 4.5_degC);
+    EXPECT_EQ(10_degC / 3, 3.33_degC);
+    EXPECT_EQ(20_degC / 3, 6.67_degC);
+    Temperature sum;
+    sum += 1.25_degC;
+    sum -= 0.5_degC;
+    EXPECT_EQ(sum, 0.75_degC);
+}
+
+TEST(TemperatureTest, Comparison) {
+    EXPECT_LT(59.75_degC, 60_degC);
+    EXPECT_GE(60_degC, 60_degC);
+    EXPECT_GT(-1_degC * -1, 0_degC);
+    EXPECT_NE(60_degC, 60.25_degC);
+}
+
+TEST(TemperatureTest, WholeDegreesAreRounded) {
+    EXPECT_EQ((60.49_degC).wholeDegrees(), 60);
+    EXPECT_EQ((60.5_degC).wholeDegrees(), 61);
+    EXPECT_EQ((-2.5_degC).wholeDegrees(), -3);
+}
+
+TEST(TemperatureTest, FormatsSixCharacters) {
+    EXPECT_EQ(formatted(0_degC), "  0.0C");
+    EXPECT_EQ(formatted(60.25_degC), " 60.3C");
+    EXPECT_EQ(formatted(100.75_degC), "100.8C");
+    EXPECT_EQ(formatted(-5_degC), " -5.0C");
+    EXPECT_EQ(formatted(-0.25_degC), " -0.3C");
+    EXPECT_EQ(formatted(-42.5_degC), "-42.5C");
+    // out of range values are clamped
+    EXPECT_EQ(formatted(1200_degC), "999.9C");
+    EXPECT_EQ(formatted(-150_degC), "-99.9C");
+}
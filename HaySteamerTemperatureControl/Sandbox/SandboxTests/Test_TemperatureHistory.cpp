@@ -0,0 +1,209 @@
+#include "gtest/gtest.h"
+#include "../../TemperatureHistory.h"
+
+#include <utility>
+#include <vector>
+
+namespace {
+    // small tiers to keep the tests short: 1 s samples, 4 s and 8 s entries
+    using SmallHistory = BasicTemperatureHistory<
+        HistoryTier<PackedSample, 6, 1000UL>,
+        HistoryTier<PackedAggregate, 4, 4000UL>,
+        HistoryTier<PackedAggregate, 3, 8000UL>>;
+
+    using RecentTier = HistoryTier<PackedSample, 6, 1000UL>;
+
+    template<typename Range>
+    std::vector<unsigned long> timesOf(const Range& range) {
+        std::vector<unsigned long> times;
+        for (const HistoryPoint& point : range) times.push_back(point.timeStamp);
+        return times;
+    }
+
+    HistoryRollup single(Temperature value) {
+        HistoryRollup rollup;
+        rollup.add(value);
+        return rollup;
+    }
+}
+
+TEST(TemperatureHistoryTest, RollupKeepsMinimumMaximumAndMean) {
+    HistoryRollup rollup;
+    rollup.add(60_degC);
+    rollup.add(58.25_degC);
+    rollup.add(63_degC);
+    EXPECT_EQ(rollup.getCount(), 3);
+    EXPECT_EQ(rollup.getMinimum(), 58.25_degC);
+    EXPECT_EQ(rollup.getMaximum(), 63_degC);
+    EXPECT_EQ(rollup.getMean(), 60.42_degC);
+    rollup.clear();
+    EXPECT_EQ(rollup.getCount(), 0);
+    EXPECT_EQ(rollup.getMean(), 0_degC);
+}
+
+TEST(TemperatureHistoryTest, TierOverwritesTheOldestEntry) {
+    RecentTier tier;
+    EXPECT_TRUE(tier.empty());
+    for (int second = 1; second <= 8; ++second) {
+        tier.add(second * 1000UL, single(Temperature::fromCelsius(second)));
+    }
+    EXPECT_EQ(tier.size(), 6u);
+    EXPECT_EQ(tier.at(0).mean, 8_degC);
+    EXPECT_EQ(tier.at(0).timeStamp, 8000u);
+    EXPECT_EQ(tier.at(5).mean, 3_degC);
+    EXPECT_EQ(tier.at(5).timeStamp, 3000u);
+}
+
+TEST(TemperatureHistoryTest, QueryReturnsTheEntriesInTheRangeOldestFirst) {
+    RecentTier tier;
+    for (int second = 1; second <= 8; ++second) {
+        tier.add(second * 1000UL, single(Temperature::fromCelsius(second)));
+    }
+    EXPECT_EQ(timesOf(tier.query(4000, 6000)), (std::vector<unsigned long>{ 4000, 5000, 6000 }));
+    EXPECT_EQ(timesOf(tier.query(4500, 6500)), (std::vector<unsigned long>{ 5000, 6000 }));
+    // clipped to the stored entries
+    EXPECT_EQ(timesOf(tier.query(0, 4000)), (std::vector<unsigned long>{ 3000, 4000 }));
+    EXPECT_EQ(timesOf(tier.query(7000, 20000)), (std::vector<unsigned long>{ 7000, 8000 }));
+    EXPECT_TRUE(tier.query(9000, 20000).empty());
+    EXPECT_TRUE(tier.query(6000, 4000).empty());
+    EXPECT_TRUE(tier.query(4200, 4800).empty());
+
+    std::vector<Temperature> values;
+    for (const HistoryPoint& point : tier.last(3000)) values.push_back(point.mean);
+    EXPECT_EQ(values, (std::vector<Temperature>{ 6_degC, 7_degC, 8_degC }));
+    EXPECT_TRUE(tier.last(0).empty());
+}
+
+TEST(TemperatureHistoryTest, QueryWorksAcrossTimerWraparound) {
+    RecentTier tier;
+    const unsigned long start = 0xFFFFFFFFUL - 2500;
+    for (unsigned long i = 0; i < 6; ++i) {
+        tier.add(start + i * 1000, single(Temperature::fromCelsius(static_cast<long>(i))));
+    }
+    EXPECT_EQ(tier.last(4000).size(), 4u);
+    EXPECT_EQ(timesOf(tier.query(start + 2000, start + 4000)),
+              (std::vector<unsigned long>{ start + 2000, start + 3000, start + 4000 }));
+}
+
+TEST(TemperatureHistoryTest, SamplesRollUpIntoTheCoarserTiers) {
+    SmallHistory history;
+    // 60, 61, ... one degree per second, the sample at 16 s closes the periods before it
+    for (unsigned long second = 0; second <= 16; ++second) {
+        history.add(second * 1000, Temperature::fromCelsius(60 + static_cast<long>(second)));
+    }
+    EXPECT_EQ(history.recent().size(), 6u);
+    EXPECT_EQ(history.recent().at(0).timeStamp, 15000u);
+    ASSERT_EQ(history.day().size(), 4u);
+    // 60..63, 64..67, 68..71, 72..75
+    HistoryPoint first = history.day().at(3);
+    EXPECT_EQ(first.timeStamp, 0u);
+    EXPECT_EQ(first.minimum, 60_degC);
+    EXPECT_EQ(first.maximum, 63_degC);
+    EXPECT_EQ(first.mean, 61.5_degC);
+    EXPECT_EQ(history.day().at(0).mean, 73.5_degC);
+
+    ASSERT_EQ(history.week().size(), 2u);
+    HistoryPoint week = history.week().at(1);
+    EXPECT_EQ(week.timeStamp, 0u);
+    EXPECT_EQ(week.minimum, 60_degC);
+    EXPECT_EQ(week.maximum, 67_degC);
+    EXPECT_EQ(week.mean, 63.5_degC);
+    EXPECT_EQ(history.week().at(0).minimum, 68_degC);
+}
+
+TEST(TemperatureHistoryTest, IrregularSampleTimesRollUpByTime) {
+    SmallHistory history;
+    // a pipelined extra sample at 1.5 s, no samples at 3 s and 4 s, two samples at 5 s
+    const std::vector<std::pair<unsigned long, Temperature>> samples = {
+        { 0, 60_degC }, { 1000, 61_degC }, { 1500, 63_degC }, { 2000, 62_degC },
+        { 5200, 70_degC }, { 5300, 70_degC }, { 9100, 80_degC } };
+    for (const auto& sample : samples) {
+        history.add(sample.first, sample.second);
+    }
+
+    // one entry per second, the skipped seconds are empty
+    EXPECT_EQ(timesOf(history.recent().query(0, 9000)), (std::vector<unsigned long>{ 0, 1000, 2000, 3000, 4000, 5000 }));
+    EXPECT_EQ(history.recent().at(0).mean, 70_degC);
+    EXPECT_FALSE(history.recent().at(1).valid);
+    EXPECT_FALSE(history.recent().at(2).valid);
+    EXPECT_EQ(history.recent().at(2).mean, 0_degC);
+    EXPECT_TRUE(history.recent().at(3).valid);
+    // the recent tier keeps only the mean of the two samples in the second
+    HistoryPoint burst = history.recent().at(4);
+    EXPECT_EQ(burst.timeStamp, 1000u);
+    EXPECT_EQ(burst.mean, 62_degC);
+
+    // the 4 s periods hold the samples taken in them, not a fixed number of samples
+    ASSERT_EQ(history.day().size(), 2u);
+    HistoryPoint first = history.day().at(1);
+    EXPECT_EQ(first.timeStamp, 0u);
+    EXPECT_EQ(first.minimum, 60_degC);
+    EXPECT_EQ(first.maximum, 63_degC);
+    EXPECT_EQ(first.mean, 61.5_degC);
+    EXPECT_EQ(history.day().at(0).timeStamp, 4000u);
+    EXPECT_EQ(history.day().at(0).mean, 70_degC);
+
+    ASSERT_EQ(history.week().size(), 1u);
+    EXPECT_EQ(history.week().at(0).timeStamp, 0u);
+    EXPECT_EQ(history.week().at(0).minimum, 60_degC);
+    EXPECT_EQ(history.week().at(0).maximum, 70_degC);
+    EXPECT_EQ(history.week().at(0).mean, 64.33_degC);
+}
+
+TEST(TemperatureHistoryTest, LongGapLeavesOnlyEmptyEntries) {
+    SmallHistory history;
+    history.add(0, 60_degC);
+    history.add(1000, 61_degC);
+    history.add(100000, 70_degC);
+    history.add(101000, 71_degC);
+    ASSERT_EQ(history.recent().size(), 6u);
+    EXPECT_EQ(history.recent().at(0).timeStamp, 100000u);
+    EXPECT_EQ(history.recent().at(0).mean, 70_degC);
+    for (size_t age = 1; age < 6; ++age) {
+        EXPECT_FALSE(history.recent().at(age).valid);
+    }
+    EXPECT_EQ(history.recent().at(5).timeStamp, 95000u);
+}
+
+TEST(TemperatureHistoryTest, PeriodsContinueAcrossTimerWraparound) {
+    SmallHistory history;
+    const unsigned long start = 0xFFFFFFFFUL - 2500;
+    const unsigned long periodStart = start - start % 1000;
+    for (unsigned long i = 0; i < 8; ++i) {
+        history.add(start + i * 1000, Temperature::fromCelsius(static_cast<long>(60 + i)));
+    }
+    ASSERT_EQ(history.recent().size(), 6u);
+    EXPECT_EQ(history.recent().at(0).timeStamp, periodStart + 6000);
+    EXPECT_EQ(history.recent().at(0).mean, 66_degC);
+    EXPECT_EQ(history.recent().at(5).timeStamp, periodStart + 1000);
+    EXPECT_EQ(history.recent().last(3000).size(), 3u);
+}
+
+TEST(TemperatureHistoryTest, UnfinishedPeriodIsNotStored) {
+    SmallHistory history;
+    for (unsigned long second = 1; second <= 7; ++second) {
+        history.add(second * 1000, 60_degC);
+    }
+    EXPECT_EQ(history.day().size(), 1u);
+    EXPECT_TRUE(history.week().empty());
+    history.clear();
+    EXPECT_TRUE(history.recent().empty());
+    history.add(1000, 60_degC);
+    EXPECT_TRUE(history.day().empty());
+}
+
+TEST(TemperatureHistoryTest, PackingKeepsQuarterDegreesAndClamps) {
+    RecentTier tier;
+    tier.add(1000, single(-20.25_degC));
+    EXPECT_EQ(tier.at(0).mean, -20.25_degC);
+    tier.add(2000, single(1000_degC));
+    EXPECT_EQ(tier.at(0).mean, 327.67_degC);
+    // the lowest value marks an empty entry
+    tier.add(3000, single(-1000_degC));
+    EXPECT_TRUE(tier.at(0).valid);
+    EXPECT_EQ(tier.at(0).mean, -327.67_degC);
+}
+
+TEST(TemperatureHistoryTest, DefaultHistoryFitsIntoAFewKilobytes) {
+    EXPECT_LT(sizeof(TemperatureHistory), 4u * 1024u + 256u);
+}
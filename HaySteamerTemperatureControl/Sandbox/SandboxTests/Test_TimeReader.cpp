@@ -57,3 +57,30 @@ TEST(TimeReaderTest, MultipleUpdates) {
     reader.update();
     EXPECT_EQ(reader.getDisplayString(), "00:00 01.01.2021");
 }
+
+TEST(TimeReaderTest, ReturnsWeekday) {
+    MockNTPClock mockClock;
+    TimeReader reader(&mockClock);
+    EXPECT_CALL(mockClock, read())
+        .WillOnce(Return(0))            // 1970-01-01 was a thursday
+        .WillOnce(Return(951827696))    // 2000-02-29 was a tuesday
+        .WillOnce(Return(1609459199));  // 2020-12-31 was a thursday
+    reader.update();
+    EXPECT_EQ(reader.getWeekday(), 4);
+    reader.update();
+    EXPECT_EQ(reader.getWeekday(), 2);
+    reader.update();
+    EXPECT_EQ(reader.getWeekday(), 4);
+}
+
+TEST(TimeReaderTest, ReturnsMinuteOfWeek) {
+    MockNTPClock mockClock;
+    TimeReader reader(&mockClock);
+    EXPECT_CALL(mockClock, read())
+        .WillOnce(Return(951827696))              // tuesday 12:34
+        .WillOnce(Return(951827696 + 5 * 86400)); // sunday 12:34
+    reader.update();
+    EXPECT_EQ(reader.getMinuteOfWeek(), 1440UL + 12 * 60 + 34);
+    reader.update();
+    EXPECT_EQ(reader.getMinuteOfWeek(), 6 * 1440UL + 12 * 60 + 34);
+}
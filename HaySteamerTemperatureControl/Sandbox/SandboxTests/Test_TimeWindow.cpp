@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+#include "../../TimeWindow.h"
+
+TEST(TimeWindowTest, ContainsTimesWithinTheDay) {
+    constexpr TimeWindow window(8 * 60, 60); // 08:00 - 09:00
+    static_assert(window.contains(8 * 60), "start is inside");
+    EXPECT_TRUE(window.contains(8 * 60 + 59));
+    EXPECT_FALSE(window.contains(9 * 60));
+    EXPECT_FALSE(window.contains(7 * 60 + 59));
+    EXPECT_EQ(window.end(), 9u * 60);
+}
+
+TEST(TimeWindowTest, RunsOverMidnight) {
+    TimeWindow window(23 * 60 + 30, 60); // 23:30 - 00:30
+    EXPECT_TRUE(window.contains(23 * 60 + 45));
+    EXPECT_TRUE(window.contains(15));
+    EXPECT_FALSE(window.contains(30));
+    EXPECT_FALSE(window.contains(23 * 60 + 29));
+    EXPECT_EQ(window.end(), 30u);
+}
+
+TEST(TimeWindowTest, LengthIsLimitedToADay) {
+    TimeWindow window(600, 5000);
+    EXPECT_EQ(window.length, TimeWindow::minutesPerDay);
+    EXPECT_TRUE(window.contains(599));
+    EXPECT_FALSE(TimeWindow(600, 0).contains(600));
+}
+
+TEST(TimeWindowTest, MinutesSinceWraps) {
+    EXPECT_EQ(TimeWindow::minutesSince(1430, 5), 15u);
+    EXPECT_EQ(TimeWindow::minutesSince(5, 1430), 1425u);
+    EXPECT_EQ(TimeWindow::minutesSince(100, 100), 0u);
+}
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "../../WeeklySchedule.h"
+
+namespace {
+    constexpr uint8_t monday = 1;
+    constexpr uint8_t wednesday = 3;
+    constexpr uint8_t saturday = 6;
+    constexpr uint8_t sunday = 7;
+
+    unsigned long at(uint8_t weekday, unsigned long hour, unsigned long minute = 0) {
+        return WeeklySchedule<1>::toMinuteOfWeek(weekday, hour * 60 + minute);
+    }
+}
+
+TEST(WeeklyScheduleTest, KeepsSlotsSorted) {
+    WeeklySchedule<4> schedule;
+    schedule.addSlot(wednesday, 6 * 60, 70, 30);
+    schedule.addSlot(monday, 18 * 60, 60, 20);
+    schedule.addSlot(sunday, 6 * 60, 65, 40);
+    schedule.addSlot(monday, 6 * 60, 60, 30);
+    ASSERT_EQ(schedule.size(), 4u);
+    EXPECT_EQ(schedule[0].minuteOfWeek, at(monday, 6));
+    EXPECT_EQ(schedule[1].minuteOfWeek, at(monday, 18));
+    EXPECT_EQ(schedule[2].minuteOfWeek, at(wednesday, 6));
+    EXPECT_EQ(schedule[3].minuteOfWeek, at(sunday, 6));
+    EXPECT_EQ(schedule[2].temperature, 70);
+}
+
+TEST(WeeklyScheduleTest, RejectsSlotsWhenFull) {
+    WeeklySchedule<2> schedule;
+    EXPECT_TRUE(schedule.addSlot(monday, 0, 60, 30));
+    EXPECT_TRUE(schedule.addSlot(monday, 60, 60, 30));
+    EXPECT_FALSE(schedule.addSlot(monday, 120, 60, 30));
+    EXPECT_EQ(schedule.size(), 2u);
+}
+
+TEST(WeeklyScheduleTest, FindNextWrapsToTheStartOfTheWeek) {
+    WeeklySchedule<4> schedule;
+    schedule.addSlot(monday, 6 * 60, 60, 30);
+    schedule.addSlot(wednesday, 6 * 60, 60, 30);
+    EXPECT_EQ(schedule.findNext(0), 0u);
+    EXPECT_EQ(schedule.findNext(at(monday, 6)), 0u);
+    EXPECT_EQ(schedule.findNext(at(monday, 6, 1)), 1u);
+    EXPECT_EQ(schedule.findNext(at(sunday, 23)), 0u);
+}
+
+TEST(WeeklyScheduleTest, DailySlotsFollowTheDaysMask) {
+    using Schedule = WeeklySchedule<14>;
+    Schedule schedule;
+    EXPECT_EQ(schedule.addDailySlot(6 * 60, 60, 30, Schedule::workDays), 5);
+    EXPECT_EQ(schedule.addDailySlot(8 * 60, 70, 45, Schedule::weekend), 2);
+    EXPECT_EQ(schedule.addDailySlot(18 * 60, 60, 30), 7);
+    EXPECT_EQ(schedule.size(), 14u);
+    EXPECT_EQ(schedule[schedule.findNext(at(saturday, 0))].temperature, 70);
+    EXPECT_EQ(schedule[schedule.findNext(at(saturday, 0))].minuteOfWeek, at(saturday, 8));
+    EXPECT_EQ(schedule.addDailySlot(20 * 60, 60, 30), 0);
+}
+
+TEST(WeeklyScheduleTest, RejectsSlotsTheKeypadCouldNotEnter) {
+    WeeklySchedule<4> schedule;
+    EXPECT_FALSE(schedule.addSlot(0, 6 * 60, 60, 30));             // no weekday
+    EXPECT_FALSE(schedule.addSlot(8, 6 * 60, 60, 30));
+    EXPECT_FALSE(schedule.addSlot(monday, 24 * 60, 60, 30));       // not a minute of the day
+    EXPECT_FALSE(schedule.addSlot(monday, 6 * 60, 60, 0));         // no holding time
+    EXPECT_FALSE(schedule.addSlot(monday, 6 * 60, 60, MAX_SPAN + 1));
+    EXPECT_FALSE(schedule.addSlot(monday, 6 * 60, -1, 30));
+    EXPECT_FALSE(schedule.addSlot(monday, 6 * 60, MAX_TEMPERATURE + 1, 30));
+    EXPECT_EQ(schedule.addDailySlot(6 * 60, 60, 30, 0), 0);        // no day
+    EXPECT_EQ(schedule.addDailySlot(6 * 60, 60, 0), 0);
+    EXPECT_EQ(schedule.size(), 0u);
+    EXPECT_TRUE(schedule.addSlot(sunday, 23 * 60 + 59, MAX_TEMPERATURE, MAX_SPAN));
+}
+
+TEST(WeeklyScheduleTest, PollReportsEachStartOnce) {
+    WeeklySchedule<4> schedule;
+    schedule.addSlot(monday, 6 * 60, 60, 30);
+    schedule.addSlot(monday, 18 * 60, 65, 20);
+
+    EXPECT_EQ(schedule.poll(at(monday, 5)), nullptr);
+    EXPECT_TRUE(schedule.isArmed());
+    EXPECT_EQ(schedule.getArmedSlot().temperature, 60);
+    EXPECT_EQ(schedule.poll(at(monday, 5, 59)), nullptr);
+
+    const ScheduleSlot* reached = schedule.poll(at(monday, 6));
+    ASSERT_NE(reached, nullptr);
+    EXPECT_EQ(reached->temperature, 60);
+    EXPECT_EQ(schedule.poll(at(monday, 6)), nullptr);
+    EXPECT_EQ(schedule.getArmedSlot().temperature, 65);
+
+    // a missed minute still starts the run
+    reached = schedule.poll(at(monday, 18, 2));
+    ASSERT_NE(reached, nullptr);
+    EXPECT_EQ(reached->temperature, 65);
+    EXPECT_EQ(schedule.getArmedSlot().temperature, 60);
+}
+
+TEST(WeeklyScheduleTest, PastStartsWaitForTheNextWeek) {
+    WeeklySchedule<2> schedule;
+    schedule.addSlot(monday, 6 * 60, 60, 30);
+    EXPECT_EQ(schedule.poll(at(monday, 7)), nullptr);
+    EXPECT_EQ(schedule.poll(at(sunday, 23, 59)), nullptr);
+    EXPECT_NE(schedule.poll(at(monday, 6)), nullptr);
+    EXPECT_EQ(schedule.poll(at(monday, 6, 30)), nullptr);
+}
+
+TEST(WeeklyScheduleTest, ChangesRearmTheSchedule) {
+    WeeklySchedule<4> schedule;
+    schedule.addSlot(wednesday, 6 * 60, 60, 30);
+    EXPECT_EQ(schedule.poll(at(monday, 0)), nullptr);
+    schedule.addSlot(monday, 1 * 60, 70, 30);
+    EXPECT_FALSE(schedule.isArmed());
+    const ScheduleSlot* reached = schedule.poll(at(monday, 1));
+    ASSERT_NE(reached, nullptr);
+    EXPECT_EQ(reached->temperature, 70);
+
+    schedule.clear();
+    EXPECT_EQ(schedule.poll(at(wednesday, 6)), nullptr);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "millis.h"
+#include "Sensor.h"
+#include "Actor.h"
+#include "Status.h"
+#include "StringConversion.h"
+#include "../Temperature.h"
+
+// Device models for the simulation, all of them follow the virtual sandbox clock.
+
+// NTP clock: local time in seconds since epoch, advancing with millis()
+class SimulatedClock final : public Sensor<time_t> {
+public:
+    SimulatedClock(time_t epochAtZeroMillis) : epochAtZeroMillis(epochAtZeroMillis) {}
+    time_t read() override { return epochAtZeroMillis + static_cast<time_t>(millis() / 1000); }
+private:
+    time_t epochAtZeroMillis;
+};
+
+// Hay bale heated by the steam generator.
+// First order model: with the relay on, the temperature approaches the steam temperature,
+// with the relay off it approaches the ambient temperature.
+class SimulatedHayBale final : public Sensor<Temperature> {
+public:
+    struct Parameters {
+        double ambientTemperature = 20.0;
+        double steamTemperature = 100.0;
+        double heatingTimeConstant = 60.0 * 60000;  // in ms
+        double coolingTimeConstant = 240.0 * 60000; // in ms
+    };
+
+    SimulatedHayBale() : SimulatedHayBale(Parameters()) {}
+    SimulatedHayBale(const Parameters& parameters)
+        : parameters(parameters)
+        , temperature(parameters.ambientTemperature)
+        , lastUpdate(millis())
+    {}
+
+    // in quarter degrees like the MAX6675
+    Temperature read() override
+    {
+        integrate();
+        return Temperature::fromCounts(std::lround(temperature * 4), 4);
+    }
+
+    void setHeating(bool on)
+    {
+        integrate();
+        heating = on;
+    }
+
+    void setTemperature(double value)
+    {
+        integrate();
+        temperature = value;
+    }
+
+    double getTemperature() { integrate(); return temperature; }
+    bool isHeating() const { return heating; }
+
+private:
+    void integrate()
+    {
+        unsigned long currentTime = millis();
+        double elapsed = static_cast<double>(currentTime - lastUpdate);
+        lastUpdate = currentTime;
+        double target = heating ? parameters.steamTemperature : parameters.ambientTemperature;
+        double timeConstant = heating ? parameters.heatingTimeConstant : parameters.coolingTimeConstant;
+        temperature = target + (temperature - target) * std::exp(-elapsed / timeConstant);
+    }
+
+    Parameters parameters;
+    double temperature;
+    unsigned long lastUpdate;
+    bool heating = false;
+};
+
+// keypad returning every scripted key exactly once, 'N' (no key) otherwise
+// every key press raises the key interrupt, like the interrupt pin of the I2C keypad
+class SimulatedKeypad final : public Sensor<char> {
+public:
+    using InterruptHandler = std::function<void()>;
+
+    char read() override
+    {
+        if (keys.empty()) {
+            return 'N';
+        }
+        char key = keys.front();
+        keys.pop_front();
+        return key;
+    }
+
+    void press(char key)
+    {
+        keys.push_back(key);
+        if (onKeyChanged) onKeyChanged();
+    }
+    void type(const char* text) { while (*text) press(*text++); }
+
+    void setInterruptHandler(InterruptHandler handler) { onKeyChanged = handler; }
+
+private:
+    std::deque<char> keys;
+    InterruptHandler onKeyChanged;
+};
+
+// display keeping the last written lines
+class SimulatedDisplay final : public Actor<String[4]> {
+public:
+    void setup() override {}
+    void write(String content[4]) override
+    {
+        for (int i = 0; i < 4; ++i) {
+            lines[i] = content[i];
+        }
+        ++writeCount;
+    }
+
+    String lines[4];
+    unsigned long writeCount = 0;
+};
+
+// relay switching the steam generator of the hay bale
+class SimulatedRelay final : public Actor<std::byte> {
+public:
+    SimulatedRelay(SimulatedHayBale& bale) : bale(bale) {}
+    void setup() override {}
+    void write(std::byte value) override
+    {
+        bool on = std::to_integer<int>(value) != 0;
+        if (on != bale.isHeating()) {
+            ++switchCount;
+        }
+        bale.setHeating(on);
+    }
+
+    unsigned long switchCount = 0;
+private:
+    SimulatedHayBale& bale;
+};
+
+// status LED recording every change of the displayed status
+class SimulatedLED final : public Actor<Status> {
+public:
+    struct Change {
+        unsigned long timeStamp;
+        Status status;
+    };
+
+    void setup() override {}
+    void write(Status status) override
+    {
+        if (changes.empty() || changes.back().status != status) {
+            changes.push_back(Change{ millis(), status });
+        }
+    }
+
+    Status current() const { return changes.empty() ? Status::idle : changes.back().status; }
+
+    std::vector<Change> changes;
+};
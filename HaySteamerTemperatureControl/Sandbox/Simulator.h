@@ -0,0 +1,119 @@
+#pragma once
+
+#include <functional>
+#include <map>
+
+#include "millis.h"
+#include "../DeadlineQueue.h"
+
+// Discrete event simulation with a virtual clock.
+// The simulator owns the sandbox clock while it exists: millis() and micros() return the virtual time.
+// run() jumps straight from one event to the next, an event is either a task deadline of the
+// scheduler or a scripted event (key press, start button, sensor change ...).
+// Only one simulator may exist at a time.
+// Times are compared like on the target (isTimeReached), so a simulation may cross the millis() wraparound,
+// the scripted events are ordered by their time since the start of the simulation.
+template<typename Scheduler>
+class Simulator {
+public:
+    using Event = std::function<void()>;
+
+    Simulator(Scheduler& scheduler, unsigned long startMillis = 0)
+        : scheduler(scheduler)
+        , origin(startMillis)
+    {
+        SandboxClock::useVirtualTime = true;
+        SandboxClock::virtualMillis = startMillis;
+        scheduler.initializeTasks();
+    }
+
+    ~Simulator()
+    {
+        SandboxClock::useVirtualTime = false;
+    }
+
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+
+    // current virtual time in milliseconds
+    unsigned long now() const { return SandboxClock::virtualMillis; }
+
+    // schedule a scripted event at an absolute virtual time
+    void at(unsigned long timeStamp, Event event)
+    {
+        events.emplace(timeStamp - origin, std::move(event));
+    }
+
+    // schedule a scripted event relative to the current virtual time
+    void after(unsigned long delay, Event event)
+    {
+        at(now() + delay, std::move(event));
+    }
+
+    // advance the virtual time to endTime, processing all events on the way
+    void runUntil(unsigned long endTime)
+    {
+        while (!isTimeReached(now(), endTime)) {
+            unsigned long next = endTime;
+            if (!isTimeReached(scheduler.nextDeadline(), next)) {
+                next = scheduler.nextDeadline();
+            }
+            if (!events.empty() && !isTimeReached(nextEventTime(), next)) {
+                next = nextEventTime();
+            }
+            if (!isTimeReached(now(), next)) {
+                idleTime += next - now();
+                SandboxClock::virtualMillis = next;
+            }
+
+            // scripted events first, so inputs are in place when the tasks run
+            while (!events.empty() && isTimeReached(now(), nextEventTime())) {
+                Event event = std::move(events.begin()->second);
+                events.erase(events.begin());
+                event();
+                ++eventCount;
+            }
+
+            if (scheduler.isTaskDue(now())) {
+                scheduler.executeCyclicTasks();
+                ++passCount;
+            }
+        }
+    }
+
+    // advance the virtual time by duration
+    void runFor(unsigned long duration)
+    {
+        runUntil(now() + duration);
+    }
+
+    // advance the virtual time until the condition is met or the time limit is reached
+    // returns true if the condition was met
+    bool runUntil(const std::function<bool()>& condition, unsigned long timeLimit)
+    {
+        const unsigned long endTime = now() + timeLimit;
+        while (!condition()) {
+            if (isTimeReached(now(), endTime)) {
+                return false;
+            }
+            unsigned long step = !isTimeReached(now(), scheduler.nextDeadline()) ? scheduler.nextDeadline() : now() + 1;
+            runUntil(!isTimeReached(step, endTime) ? step : endTime);
+        }
+        return true;
+    }
+
+    // number of scheduler passes, scripted events and virtual time spent waiting for the next event
+    unsigned long getPassCount() const { return passCount; }
+    unsigned long getEventCount() const { return eventCount; }
+    unsigned long getIdleTime() const { return idleTime; }
+
+private:
+    unsigned long nextEventTime() const { return events.begin()->first + origin; }
+
+    Scheduler& scheduler;
+    unsigned long origin;                           // virtual time at the start, events are keyed relative to it
+    std::multimap<unsigned long, Event> events;
+    unsigned long passCount = 0;
+    unsigned long eventCount = 0;
+    unsigned long idleTime = 0;
+};
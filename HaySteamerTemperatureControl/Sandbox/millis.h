@@ -3,10 +3,30 @@
 #ifndef USE_TEST_MILLIS
 #include <chrono>
 
+// Virtual time for unit tests and the simulation.
+// While useVirtualTime is set, millis() and micros() return virtualMillis instead of the host clock.
+struct SandboxClock {
+    static inline bool useVirtualTime = false;
+    static inline unsigned long virtualMillis = 0;
+};
+
 // Mock implementation of millis() for sandbox environment
 inline unsigned long millis() {
+    if (SandboxClock::useVirtualTime) {
+        return SandboxClock::virtualMillis;
+    }
     static auto startTime = std::chrono::steady_clock::now();
     auto currentTime = std::chrono::steady_clock::now();
     return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count());
 }
-#endif
\ No newline at end of file
+
+// Mock implementation of micros() for sandbox environment
+inline unsigned long micros() {
+    if (SandboxClock::useVirtualTime) {
+        return SandboxClock::virtualMillis * 1000;
+    }
+    static auto startTime = std::chrono::steady_clock::now();
+    auto currentTime = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(currentTime - startTime).count());
+}
+#endif
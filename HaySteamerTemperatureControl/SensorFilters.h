@@ -0,0 +1,251 @@
+#ifndef SENSORFILTERS_H
+#define SENSORFILTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "Temperature.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+
+#include "Sandbox/Sensor.h"
+#endif
+
+#ifdef ARDUINO
+#include <Sensor.h>
+#endif
+
+// Filter stages for Filtered<>. A stage is a policy with a nested Stage<T> that holds the fixed-size state
+// and filters one value per call, the first value passes unchanged and sets the state.
+// The stages compute on the raw integer of the value, see FilterRaw, the parameters are raw values as well:
+// for a Temperature, RateLimit<25> is 0.25 degree per reading.
+
+/// <summary>
+/// Raw integer of a filtered value, integers are their own raw value.
+/// </summary>
+template<typename T>
+struct FilterRaw {
+    static long toRaw(T value) { return static_cast<long>(value); }
+    static T fromRaw(long raw) { return static_cast<T>(raw); }
+};
+
+template<>
+struct FilterRaw<Temperature> {
+    static long toRaw(Temperature value) { return value.centiCelsius(); }
+    static Temperature fromRaw(long raw) { return Temperature::fromCentiCelsius(raw); }
+};
+
+/// <summary>
+/// Median of the last N values, removes single spikes. The values are also kept sorted,
+/// a new value replaces the oldest one in the sorted copy, there is no full sort per value.
+/// </summary>
+template<uint8_t N>
+struct Median {
+    static_assert(N >= 1, "a median of at least one value");
+
+    template<typename T>
+    class Stage {
+    public:
+        T operator()(T value)
+        {
+            if (count < N) {
+                insert(count++, value);
+            }
+            else {
+                // remove the oldest value from the sorted copy
+                size_t i = 0;
+                while (sorted[i] != history[next]) ++i;
+                for (; i + 1 < N; ++i) sorted[i] = sorted[i + 1];
+                insert(N - 1, value);
+            }
+            history[next] = value;
+            next = (next + 1) % N;
+            return sorted[(count - 1) / 2];
+        }
+
+        void reset() { count = 0; next = 0; }
+
+    private:
+        // inserts into the sorted values [0, used)
+        void insert(size_t used, T value)
+        {
+            size_t i = used;
+            while (i > 0 && value < sorted[i - 1]) {
+                sorted[i] = sorted[i - 1];
+                --i;
+            }
+            sorted[i] = value;
+        }
+
+        T history[N] = {};
+        T sorted[N] = {};
+        size_t count = 0;
+        size_t next = 0;
+    };
+};
+
+/// <summary>
+/// Exponential moving average with alpha = Numerator / Denominator.
+/// The average is kept with 8 fraction bits, small steps are not lost to the integer division
+/// and a constant input is reached exactly.
+/// </summary>
+template<long Numerator, long Denominator>
+struct Ema {
+    static_assert(Numerator > 0 && Numerator <= Denominator, "0 < alpha <= 1");
+    static_assert(Denominator / Numerator < 128, "the fraction bits must resolve alpha");
+
+    template<typename T>
+    class Stage {
+    public:
+        T operator()(T value)
+        {
+            const long input = FilterRaw<T>::toRaw(value) * scale;
+            if (!started) {
+                scaled = input;
+                started = true;
+            }
+            else {
+                scaled += (input - scaled) * Numerator / Denominator;
+            }
+            // rounded to the nearest value
+            return FilterRaw<T>::fromRaw(scaled >= 0 ? (scaled + scale / 2) / scale : (scaled - scale / 2) / scale);
+        }
+
+        void reset() { started = false; }
+
+    private:
+        static constexpr long scale = 256;
+        long scaled = 0;    // average * scale
+        bool started = false;
+    };
+};
+
+/// <summary>
+/// Limits the change per value to MaxStep, a jump is followed as a ramp.
+/// </summary>
+template<long MaxStep>
+struct RateLimit {
+    static_assert(MaxStep > 0, "a positive step");
+
+    template<typename T>
+    class Stage {
+    public:
+        T operator()(T value)
+        {
+            if (!started) {
+                last = FilterRaw<T>::toRaw(value);
+                started = true;
+            }
+            else {
+                const long step = FilterRaw<T>::toRaw(value) - last;
+                last += step > MaxStep ? MaxStep : (step < -MaxStep ? -MaxStep : step);
+            }
+            return FilterRaw<T>::fromRaw(last);
+        }
+
+        void reset() { started = false; }
+
+    private:
+        long last = 0;
+        bool started = false;
+    };
+};
+
+/// <summary>
+/// Holds the output until the value moves more than Band away from it, a value toggling by one step
+/// does not change the output.
+/// </summary>
+template<long Band>
+struct Deadband {
+    static_assert(Band >= 0, "a band of at least zero");
+
+    template<typename T>
+    class Stage {
+    public:
+        T operator()(T value)
+        {
+            const long input = FilterRaw<T>::toRaw(value);
+            if (!started || input - held > Band || held - input > Band) {
+                held = input;
+                started = true;
+            }
+            return FilterRaw<T>::fromRaw(held);
+        }
+
+        void reset() { started = false; }
+
+    private:
+        long held = 0;
+        bool started = false;
+    };
+};
+
+/// <summary>
+/// The stages of a Filtered<>, each one feeds the next, in the order they are listed.
+/// </summary>
+template<typename T, typename... Stages>
+class FilterChain {
+public:
+    T operator()(T value) { return value; }
+    void reset() { }
+};
+
+template<typename T, typename First, typename... Rest>
+class FilterChain<T, First, Rest...> {
+public:
+    T operator()(T value) { return rest(first(value)); }
+    void reset() { first.reset(); rest.reset(); }
+
+private:
+    typename First::template Stage<T> first;
+    FilterChain<T, Rest...> rest;
+};
+
+/// <summary>
+/// Filters the readings of a sensor, e.g. Filtered&lt;ProbeSampler&lt;TempProbe&gt;, Median&lt;3&gt;, Ema&lt;1, 2&gt;&gt;.
+/// The chain is composed at compile time: only the listed stages take memory and time, the calls are inlined.
+/// Functions of a sensor with probes (see ProbeSampler) are passed through, they are not filtered.
+/// </summary>
+template<typename SensorType, typename... Stages>
+class Filtered final : public Sensor<decltype(std::declval<SensorType&>().read())> {
+public:
+    using ValueType = decltype(std::declval<SensorType&>().read());
+
+    explicit Filtered(SensorType* sensor)
+        : sensor(sensor)
+    { }
+
+    ValueType read() override
+    {
+        raw = sensor->read();
+        return stages(raw);
+    }
+
+    // last unfiltered reading
+    ValueType getRaw() const { return raw; }
+
+    // the next reading starts the filters over
+    void reset() { stages.reset(); }
+
+    SensorType& getSensor() { return *sensor; }
+
+    template<typename S = SensorType>
+    auto getProbeCount() const -> decltype(std::declval<const S&>().getProbeCount()) { return sensor->getProbeCount(); }
+
+    template<typename S = SensorType>
+    auto getSample(uint8_t probe) const -> decltype(std::declval<const S&>().getSample(probe)) { return sensor->getSample(probe); }
+
+    template<typename S = SensorType>
+    auto getFusionResult() const -> decltype(std::declval<const S&>().getFusionResult()) { return sensor->getFusionResult(); }
+
+    template<typename S = SensorType>
+    auto getConversionTime() const -> decltype(std::declval<const S&>().getConversionTime()) { return sensor->getConversionTime(); }
+
+private:
+    SensorType* sensor;
+    FilterChain<ValueType, Stages...> stages;
+    ValueType raw{};
+};
+
+#endif
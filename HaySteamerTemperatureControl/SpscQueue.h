@@ -0,0 +1,69 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Lock-free ring buffer for exactly one producer and one consumer, e.g. an interrupt and the main loop.
+/// The producer only writes head, the consumer only writes tail, so neither side has to disable interrupts.
+/// Capacity must be a power of two, one slot stays empty to tell a full from an empty buffer.
+/// </summary>
+template<typename T, size_t Capacity>
+class SpscQueue {
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    /// <summary>
+    /// Producer side: appends an item.
+    /// </summary>
+    /// <returns>false if the queue is full, the item is dropped</returns>
+    bool push(const T& item)
+    {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        const size_t nextHead = (currentHead + 1) & mask;
+        if (nextHead == tail.load(std::memory_order_acquire)) {
+            dropped = dropped + 1;
+            return false;
+        }
+        items[currentHead] = item;
+        head.store(nextHead, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Consumer side: removes the oldest item.
+    /// </summary>
+    /// <returns>false if the queue is empty, item is not changed</returns>
+    bool pop(T& item)
+    {
+        const size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[currentTail];
+        tail.store((currentTail + 1) & mask, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    size_t size() const { return (head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)) & mask; }
+    static constexpr size_t capacity() { return Capacity - 1; }
+
+    // number of items dropped because the queue was full, only written by the producer
+    unsigned long getDropped() const { return dropped; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    T items[Capacity] = {};
+    std::atomic<size_t> head{ 0 };
+    std::atomic<size_t> tail{ 0 };
+    volatile unsigned long dropped = 0;
+};
+
+#endif
@@ -1,77 +1,179 @@
 #ifndef STARTCONDITIONS_H
 #define STARTCONDITIONS_H
 
-#include <functional>
-#include <vector> // Ensure vector is included
+#include "Delegate.h"
+#include "StaticVector.h"
+#include "ChangeTracking.h"
+#include "TimeWindow.h"
 
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
 
+#include "Sandbox/millis.h"
 #endif
 
 #ifdef ARDUINO
-
+#include <Arduino.h>
 #endif
 
+/// <summary>
+/// Sources that start the process right away. checkAllConditions() stops at the first condition met and
+/// tries the cheapest conditions first, by their declared or measured run time. An edge triggered condition is only
+/// evaluated again when its input changed and a result of true is reported once, like a latched button press.
+/// </summary>
 class StartConditions
 {
 public:
-	using ConditionFunction = std::function<bool()>;
+	using ConditionFunction = Delegate<bool()>;
 	StartConditions()
 	{ };
 
-	void setGetTimeOfDayInMinutes(std::function<unsigned long()> func) 
+	void setGetTimeOfDayInMinutes(Delegate<unsigned long()> func) 
 	{
 		if (!func) {
 			return;
 		}
 		getTimeOfDayInMinutes = func;
 	}
-	void setGetStartTimeInMinutes(std::function<unsigned long()> func) 
+	void setGetStartTimeInMinutes(Delegate<unsigned long()> func) 
 	{
 		if (!func) {
 			return;
 		}
 		getStartTimeInMinutes = func;
 	}
+	// minutes after the start time in which the timer condition is met, across midnight
+	void setTimerWindow(unsigned long lengthMinutes)
+	{
+		timerWindowLength = lengthMinutes;
+		timerCache.valid = false;
+	}
+
+	static constexpr size_t maxConditions = 4;
+	// cost of a condition that is measured instead of declared
+	static constexpr unsigned long measuredCost = ~0UL;
+	// the run time is measured on the first evaluation and then on every costSampleInterval-th,
+	// two micros() calls cost more than most conditions
+	static constexpr uint8_t costSampleInterval = 16;
 
 	/// <summary>
-	///	add condition to the list of conditions.
+	///	add condition to the list of conditions, it is evaluated on every check.
 	/// </summary>
 	/// <param name="condition function to add"></param>
-	void addCondition(const ConditionFunction& condition) 
+	/// <param name="cost">run time in microseconds used to order the conditions, measured if not given</param>
+	/// <returns>false if the condition is empty or the list is full</returns>
+	bool addCondition(const ConditionFunction& condition, unsigned long cost = measuredCost) 
 	{
 		if (!condition) {
-			return;
+			return false;
 		}
-		conditions.push_back(condition);
+		return conditions.push_back(Condition(condition, cost));
 	}
+
 	/// <summary>
-	///	check all conditions and return true if any condition is met.
+	///	add condition that only depends on input, it is evaluated again when the version of input changed.
+	/// A result of true is reported by one check only, the next true needs another change of input.
+	/// </summary>
+	/// <returns>false if the condition is empty or the list is full</returns>
+	bool addEdgeTriggeredCondition(const ConditionFunction& condition, const ChangeCounter& input, unsigned long cost = measuredCost)
+	{
+		if (!condition || conditions.full()) {
+			return false;
+		}
+		Condition edgeTriggered(condition, cost);
+		edgeTriggered.input.assign(input);
+		return conditions.push_back(edgeTriggered);
+	}
+
+	/// <summary>
+	///	check the conditions, cheapest first, and return true as soon as one is met.
 	/// </summary>
 	/// <returns>true if any condition is met, false otherwise</returns>
-	bool checkAllConditions() const 
+	bool checkAllConditions() 
 	{
 		bool conditionMet = false;
-		for (const auto& condition : conditions) {
-			conditionMet |= condition();
+		for (size_t i = 0; i < conditions.size() && !conditionMet; ++i) {
+			conditionMet = evaluate(conditions[i]);
+			// keep the list sorted by cost, one step per check is enough for the few conditions
+			if (i > 0 && conditions[i].cost < conditions[i - 1].cost) {
+				Condition cheaper = conditions[i];
+				conditions[i] = conditions[i - 1];
+				conditions[i - 1] = cheaper;
+			}
 		}
 		return conditionMet;
 	}
 
 	/// <summary>
-	///	check if the timer condition is met, i.e., if the current time of day is greater than or equal to the start time.
+	///	check if the timer condition is met, i.e., if the current time of day is in the timer window from the start time.
+	/// The result is only computed again when the time or the start time changed.
 	/// </summary>
 	/// <returns>true if the timer condition is met, false otherwise</returns>
-	bool timerCondition() const 
+	bool timerCondition() 
 	{
-		return (getTimeOfDayInMinutes() >= getStartTimeInMinutes());
+		const unsigned long time = getTimeOfDayInMinutes();
+		const unsigned long start = getStartTimeInMinutes();
+		if (!timerCache.valid || time != timerCache.time || start != timerCache.start) {
+			timerCache = TimerCache{ true, time, start, TimeWindow(start, timerWindowLength).contains(time) };
+		}
+		return timerCache.result;
+	}
+
+	// run time of the condition at position i in the current order, in microseconds
+	unsigned long getCost(size_t i) const
+	{
+		return i < conditions.size() ? conditions[i].cost : 0;
 	}
 
 private:
-	std::vector<ConditionFunction> conditions;
+	struct Condition {
+		Condition() = default;
+		Condition(const ConditionFunction& function, unsigned long declaredCost)
+			: function(function)
+			, cost(declaredCost == measuredCost ? 0 : declaredCost)
+			, measure(declaredCost == measuredCost)
+		{ }
+
+		ConditionFunction function;
+		ChangeWatch<1> input;   // watches nothing for conditions evaluated on every check
+		unsigned long cost = 0; // declared, or moving average of the sampled run times, in microseconds
+		bool measure = false;
+		uint8_t untilSample = 0;  // evaluations until the run time is sampled again
+	};
+
+	static bool evaluate(Condition& condition)
+	{
+		// without a change of its input an edge triggered condition is not met, a check already consumed the edge
+		if (condition.input.isWatching() && !condition.input.changed()) {
+			return false;
+		}
+		if (!condition.measure) {
+			return condition.function();
+		}
+		if (condition.untilSample > 0) {
+			--condition.untilSample;
+			return condition.function();
+		}
+		condition.untilSample = costSampleInterval - 1;
+		const unsigned long start = micros();
+		const bool result = condition.function();
+		const unsigned long runTime = micros() - start;
+		condition.cost = condition.cost ? (condition.cost * 3 + runTime) / 4 : runTime;
+		return result;
+	}
+
+	struct TimerCache {
+		bool valid = false;
+		unsigned long time = 0;
+		unsigned long start = 0;
+		bool result = false;
+	};
+
+	StaticVector<Condition, maxConditions> conditions;
 
-	std::function<unsigned long()> getTimeOfDayInMinutes = []() {return 0; };
-	std::function<unsigned long()> getStartTimeInMinutes = []() {return 0; };
+	Delegate<unsigned long()> getTimeOfDayInMinutes = []() {return 0; };
+	Delegate<unsigned long()> getStartTimeInMinutes = []() {return 0; };
+	unsigned long timerWindowLength = 12 * 60;
+	TimerCache timerCache;
 };
 #endif
@@ -1,8 +1,9 @@
 #ifndef StateMachine_h
 #define StateMachine_h
 
-#include <map>
-#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include "Delegate.h"
 
 
 #ifdef SANDBOX_ENVIRONMENT
@@ -19,46 +20,70 @@
 #define toString(x) String(x)
 #endif
 
+// bit of a state in the transition table
+constexpr uint8_t statusBit(Status status) { return static_cast<uint8_t>(1u << static_cast<uint8_t>(status)); }
+
 class HaySteamerStateMachine {
 public:
+  using Hook = Delegate<void(Status)>;
+  static constexpr size_t statusCount = static_cast<size_t>(Status::error) + 1;
+
   HaySteamerStateMachine()
       : currentStatus(Status::idle) {}
 
+  // allowed transitions: one bit per target state in the row of the current state
+  // error can be entered from any state, the error state is only left by a reset to idle
+  static constexpr uint8_t allowedTransitions[statusCount] = {
+    /* idle    */ statusBit(Status::ready) | statusBit(Status::heating) | statusBit(Status::error),
+    /* ready   */ statusBit(Status::heating) | statusBit(Status::error),
+    /* heating */ statusBit(Status::holding) | statusBit(Status::error),
+    /* holding */ statusBit(Status::done) | statusBit(Status::error),
+    /* done    */ statusBit(Status::idle) | statusBit(Status::error),
+    /* error   */ statusBit(Status::idle),
+  };
+
+  static constexpr bool isTransitionAllowed(Status from, Status to) {
+    return (allowedTransitions[static_cast<size_t>(from)] & statusBit(to)) != 0;
+  }
+
   void changeStatus(Status newStatus) {
     Status oldStatus = currentStatus;
     if (oldStatus == newStatus) return; // No Status change
 
-    // Allow transition to error from any state
-    if (newStatus == Status::error) {
-      currentStatus = Status::error;
-      return;
+    // a transition not in the table leads to error, an invalid request in error keeps error
+    if (!isTransitionAllowed(oldStatus, newStatus)) {
+      newStatus = Status::error;
+      if (oldStatus == newStatus) return;
     }
+    enter(newStatus);
+  }
 
-    // If currently in error, only allow reset to idle
-    if (oldStatus == Status::error && newStatus == Status::idle) {
-      currentStatus = Status::idle;
-      return;
-    }
+  Status getCurrentStatus() const { return currentStatus; }
 
-    // Allowed transitions
-    if ((oldStatus == Status::idle    && newStatus == Status::ready)   ||
-        (oldStatus == Status::idle    && newStatus == Status::heating) ||
-        (oldStatus == Status::ready   && newStatus == Status::heating) ||
-        (oldStatus == Status::heating && newStatus == Status::holding) ||
-        (oldStatus == Status::holding && newStatus == Status::done)    ||
-        (oldStatus == Status::done    && newStatus == Status::idle)) {
-      currentStatus = newStatus;
-      return;
-    }
+  // called with the next state when the state is left, and with the previous state when it is entered
+  void setOnExit(Status status, Hook hook) { onExit[static_cast<size_t>(status)] = hook; }
+  void setOnEntry(Status status, Hook hook) { onEntry[static_cast<size_t>(status)] = hook; }
 
-    // Invalid transition => error
-	currentStatus = Status::error;
+  // number of transitions along an edge since construction
+  uint16_t getTransitionCount(Status from, Status to) const {
+    return transitionCounts[static_cast<size_t>(from)][static_cast<size_t>(to)];
   }
 
-  Status getCurrentStatus() const { return currentStatus; }
-
 private:
+  void enter(Status newStatus) {
+    const Status oldStatus = currentStatus;
+    ++transitionCounts[static_cast<size_t>(oldStatus)][static_cast<size_t>(newStatus)];
+    const Hook& exitHook = onExit[static_cast<size_t>(oldStatus)];
+    if (exitHook) exitHook(newStatus);
+    currentStatus = newStatus;
+    const Hook& entryHook = onEntry[static_cast<size_t>(newStatus)];
+    if (entryHook) entryHook(oldStatus);
+  }
+
   Status currentStatus;
+  Hook onExit[statusCount];
+  Hook onEntry[statusCount];
+  uint16_t transitionCounts[statusCount][statusCount] = {};
 };
 
 #endif
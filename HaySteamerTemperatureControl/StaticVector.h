@@ -0,0 +1,72 @@
+#ifndef STATICVECTOR_H
+#define STATICVECTOR_H
+
+#include <stddef.h>
+#include <utility>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Vector with a capacity fixed at compile time. The elements are stored inside the object,
+/// so it never allocates memory on the heap.
+/// Adding an element to a full vector at run time is rejected (push_back returns false),
+/// assigning more elements than the capacity with assign() fails to compile.
+/// </summary>
+template<typename T, size_t Capacity>
+class StaticVector {
+public:
+    static_assert(Capacity > 0, "StaticVector needs a capacity of at least one element");
+
+    /// <summary>
+    /// Appends an element.
+    /// </summary>
+    /// <returns>false if the vector is full, the element is not added</returns>
+    bool push_back(const T& item)
+    {
+        if (count >= Capacity) {
+            return false;
+        }
+        items[count++] = item;
+        return true;
+    }
+
+    /// <summary>
+    /// Replaces the content with the given elements, the number of elements is checked at compile time.
+    /// </summary>
+    template<typename... Items>
+    void assign(Items&&... newItems)
+    {
+        static_assert(sizeof...(Items) <= Capacity, "StaticVector capacity exceeded");
+        clear();
+        (push_back(std::forward<Items>(newItems)), ...);
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = T();
+        }
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return Capacity; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+private:
+    T items[Capacity] = {};
+    size_t count = 0;
+};
+
+#endif
@@ -12,9 +12,16 @@
 #include "HaySteamerLogic.h"
 #include "StartConditions.h"
 #include "FaultConditions.h"
+#include "DeadlineQueue.h"
+#include "StaticVector.h"
+#include "EditEcho.h"
+#include "Idle.h"
+#include "ProcessImage.h"
+#include "WeeklySchedule.h"
+#include "TemperatureHistory.h"
 
 #include <array>
-#include <vector>
+#include <stdio.h>
 
 
 #ifdef SANDBOX_ENVIRONMENT
@@ -38,6 +45,50 @@ using namespace std;
 
 //#define DEBUG
 
+// run time, start lateness and missed cycles of a cyclic task
+struct TaskStatistics {
+    static const uint8_t latenessBuckets = 8;
+    // upper limits of the lateness histogram buckets in ms, the last bucket counts everything above
+    static constexpr unsigned long latenessLimits[latenessBuckets - 1] = { 1, 2, 5, 10, 20, 50, 100 };
+
+    // runTime in microseconds, lateness in milliseconds
+    void recordRun(const unsigned long& runTime, const unsigned long& lateness) {
+        ++runCount;
+        totalRunTime += runTime;
+        if (runTime < minRunTime) minRunTime = runTime;
+        if (runTime > maxRunTime) maxRunTime = runTime;
+
+        uint8_t bucket = 0;
+        while (bucket < latenessBuckets - 1 && lateness >= latenessLimits[bucket]) {
+            ++bucket;
+        }
+        ++latenessHistogram[bucket];
+    }
+
+    unsigned long getMeanRunTime() const {
+        return runCount ? static_cast<unsigned long>(totalRunTime / runCount) : 0;
+    }
+
+    void reset() {
+        *this = TaskStatistics();
+    }
+
+    unsigned long runCount = 0;
+    unsigned long minRunTime = ~0UL;    // in microseconds
+    unsigned long maxRunTime = 0;       // in microseconds
+    unsigned long long totalRunTime = 0; // in microseconds
+    unsigned long missedCycles = 0;     // runs dropped while catching up
+    unsigned long latenessHistogram[latenessBuckets] = {};
+};
+
+// what to do with the runs of a task that were missed because it was started too late
+enum class MissedRunPolicy : uint8_t {
+    skip,       // run the slot due now if it is at most the skip tolerance late, otherwise drop it as well and wait
+                // for the next regular slot; never two slots in a row are dropped, so an overrunning task still runs
+    coalesce,   // run once for all missed slots right away, continue with the next regular slot
+    burst       // run once for every due slot, at most maxBurstRuns times in a row
+};
+
 struct CyclicTask {
     CyclicTask(unsigned long cycle_interval)
     {
@@ -49,17 +100,77 @@ struct CyclicTask {
 	virtual ~CyclicTask() = default;
 
     virtual void initializeTaskTimer(const unsigned long& currentTimeStamp) {
-        nextRun = currentTimeStamp + interval;
+        nextRun = currentTimeStamp + interval + phaseOffset;
     };
 
+    // delays all runs of the task by offset (less than the interval), shifts the task against the other tasks
+    void setPhaseOffset(unsigned long offset) {
+        offset %= interval;
+        nextRun += (offset + interval - phaseOffset) % interval;
+        phaseOffset = offset;
+    }
+
+    // interval used to schedule the next run
+    virtual unsigned long getCurrentInterval() const {
+        return interval;
+    }
+
     virtual bool isRunScheduled(const unsigned long& currentTimeStamp)
     {
-		bool isRunScheduled = (currentTimeStamp >= nextRun);
-		// correct timing if scheduled runs were missed
-        while (currentTimeStamp >= nextRun) {
-            nextRun += interval;
+        if (!isTimeReached(currentTimeStamp, nextRun)) {
+            return false;
         }
-        return isRunScheduled;
+
+		// correct timing if scheduled runs were missed, in constant time
+        const unsigned long step = getCurrentInterval();
+        const unsigned long missedRuns = (currentTimeStamp - nextRun) / step;
+
+        switch (missedRunPolicy) {
+        case MissedRunPolicy::burst:
+            // replay one due slot per call, drop the oldest ones exceeding the burst limit:
+            // this run and the maxBurstRuns - 1 slots left behind are maxBurstRuns runs
+            if (missedRuns + 1 > maxBurstRuns) {
+                statistics.missedCycles += missedRuns + 1 - maxBurstRuns;
+                nextRun += (missedRuns + 2 - maxBurstRuns) * step;
+            } else {
+                nextRun += step;
+            }
+            return true;
+
+        case MissedRunPolicy::skip: {
+            // lateness behind the slot due now, the slots before it are dropped in any case
+            const unsigned long lateness = (currentTimeStamp - nextRun) % step;
+            statistics.missedCycles += missedRuns;
+            nextRun += (missedRuns + 1) * step;
+            if (lateness > getSkipTolerance(step) && !skippedLastSlot) {
+                ++statistics.missedCycles;
+                skippedLastSlot = true;
+                return false;
+            }
+            skippedLastSlot = false;
+            return true;
+        }
+
+        case MissedRunPolicy::coalesce:
+        default:
+            statistics.missedCycles += missedRuns;
+            nextRun += (missedRuns + 1) * step;
+            return true;
+        }
+    }
+
+    void setMissedRunPolicy(MissedRunPolicy policy, uint8_t maxBurst = 3) {
+        missedRunPolicy = policy;
+        maxBurstRuns = maxBurst > 0 ? maxBurst : 1;     // the due run itself always runs
+    }
+
+    // how late the skip policy still runs a slot, 0 is a quarter of the current interval
+    void setSkipTolerance(unsigned long tolerance_ms) {
+        skipTolerance = tolerance_ms;
+    }
+
+    unsigned long getSkipTolerance(unsigned long step) const {
+        return skipTolerance > 0 ? skipTolerance : step / 4;
     }
     virtual void cycleTask()
     {
@@ -74,13 +185,30 @@ Serial.println(nextRun);
 		}
     }
 
-    virtual void addModule(CyclicModule* module) {
-        modules.push_back(module);
+    // returns false if the task already holds maxModules modules
+    virtual bool addModule(CyclicModule* module) {
+        return modules.push_back(module);
 	}
-    std::vector<CyclicModule*> modules;
+
+    // replaces all modules, the number of modules is checked at compile time
+    template<typename... Modules>
+    void setModules(Modules*... newModules) {
+        modules.assign(static_cast<CyclicModule*>(newModules)...);
+    }
+
+    static constexpr size_t maxModules = 4;
+    StaticVector<CyclicModule*, maxModules> modules;
 
 	unsigned long interval;   // internal in milliseconds
     unsigned long nextRun = 0;    // Timestamp of next execution
+
+    unsigned long phaseOffset = 0;  // in milliseconds
+    MissedRunPolicy missedRunPolicy = MissedRunPolicy::coalesce;
+    uint8_t maxBurstRuns = 3;
+    unsigned long skipTolerance = 0;    // in milliseconds
+    bool skippedLastSlot = false;
+
+    TaskStatistics statistics;
 };
 
 struct SlowInputTask : public CyclicTask {
@@ -120,28 +248,22 @@ struct OutputTask : public CyclicTask {
 
     void enableFast() { 
         enabledFast = true; 
-        if ((lastRun + fastInterval) < nextRun) {
+        if (!isTimeReached(lastRun + fastInterval, nextRun)) {
 			nextRun = lastRun + fastInterval; // adjust next run time to fast interval
         }
     };
     void disableFast() { enabledFast = false; };
 
+    unsigned long getCurrentInterval() const override {
+        return enabledFast ? fastInterval : slowInterval;
+    }
+
     bool isRunScheduled(const unsigned long& currentTimeStamp) override
     {
-        bool isRunScheduled = (currentTimeStamp >= nextRun);
+        bool isRunScheduled = CyclicTask::isRunScheduled(currentTimeStamp);
         if (isRunScheduled) {
             lastRun = currentTimeStamp;
         }
-
-        // correct timing if scheduled runs were missed
-        while (currentTimeStamp >= nextRun) {
-            if (enabledFast) {
-                nextRun += fastInterval;
-            } else {
-                nextRun += slowInterval;
-			}
-        }
-        
         return isRunScheduled;
     }
 
@@ -158,10 +280,15 @@ struct LogicTask : public CyclicTask {
     { };
 };
 
-class CyclicCaller
+// Scheduler and module graph of the hay steamer.
+// The template parameters are the hardware types. With the concrete (final) classes of the board
+// the compiler binds read() and write() at compile time and can inline them,
+// CyclicCaller below binds the Sensor and Actor interfaces at run time, e.g. for mocks in the tests.
+template<typename ClockType, typename TempType, typename KeypadType, typename DisplayType, typename RelayType, typename LedType>
+class BasicCyclicCaller
 {
 public:
-    CyclicCaller(Sensor<time_t>* clock, Sensor<int>* temp, Sensor<char>* keypad, Actor<String[4]>* display, Actor<byte>* relay, Actor<Status>* led)
+    BasicCyclicCaller(ClockType* clock, TempType* temp, KeypadType* keypad, DisplayType* display, RelayType* relay, LedType* led)
         : slowInputTask(1000)
         , fastInputTask(100)
         , logicTask(2000)
@@ -173,6 +300,7 @@ public:
 		, relay(relay)
 		, led(led)
     {
+        queueAllTasks();
     };
 
     void initializeTasks() {
@@ -180,52 +308,106 @@ public:
         for (CyclicTask* task : tasks) {
             task->initializeTaskTimer(currentMillis);
         }
-
-		slowInputTask.addModule(&timeReader);
-		slowInputTask.addModule(&tempReader);
-
-		fastInputTask.addModule(&keypadReader);
-		fastInputTask.addModule(&parameterEditor);
-
-        logicTask.addModule(&logic);
-
-		outputTask.addModule(&display);
-		outputTask.addModule(&relay);
-		outputTask.addModule(&led);
-
-
-		parameterEditor.setCharacterProvider([&] { return keypadReader.getLatestValue(); });
-
-        logic.setStartConditions([&] { return startConditions.checkAllConditions(); });
+        queueAllTasks();
+        resetStatistics();
+
+		slowInputTask.setModules(&timeReader, &tempReader);
+		// the keypad is read on its interrupt, see onKeyChanged(), the editor drains the queued keys
+		fastInputTask.setModules(&parameterEditor, &fastOutputTrigger);
+        logicTask.setModules(&logic);
+		outputTask.setModules(&display, &relay, &led, &keyEchoProbe);
+
+
+		parameterEditor.setCharacterProvider([&] {
+            KeyEvent event;
+            if (!keypadReader.getNextEvent(event)) return '\0';
+            keyEchoProbe.keyProcessed(event.timeStamp);
+            return event.key;
+        });
+
+        // echo edits on the display at the fast output cadence for a while
+        fastOutputTrigger.setInput(parameterEditor.getChangeCounter());
+        fastOutputTrigger.setActions([&] { enableFastOutput(); }, [&] { outputTask.disableFast(); });
+        keyEchoProbe.setWriteCounter([&] { return display.getWriteCount(); });
+
+        // the logic run works on a snapshot of its inputs, the start conditions read the same snapshot
+        logic.setCapture([&](ProcessImage& image) { captureProcessImage(image); });
+        logic.setStartConditions([&] { return logic.getProcessImage().scheduledStart || startConditions.checkAllConditions(); });
 		logic.setRunTimer([&] { return startConditions.timerCondition(); });
-		logic.setStartTimer([&] { return startTimer; });
-        logic.setHasFault([&](Status state) { return faultConditions.checkConditions(state); });
-		logic.setGetTimeOfDayInMinutes([&] { return timeReader.getTimeOfDayInMinutes(); });
-		logic.setGetTemperature([&] { return tempReader.getLatestValue(); });
-		logic.setGetMinimumTemperature([&] { return parameterEditor.getTemperature(); });
-		logic.setGetWaitTime([&] { return parameterEditor.getTimeSpan(); });
 
-		startConditions.setGetTimeOfDayInMinutes([&] { return timeReader.getTimeOfDayInMinutes(); });
-		startConditions.setGetStartTimeInMinutes([&] { return parameterEditor.getTimeInMinutes(); });
+		startConditions.setGetTimeOfDayInMinutes([&] { return logic.getProcessImage().timeOfDayInMinutes; });
+		startConditions.setGetStartTimeInMinutes([&] { return logic.getProcessImage().startTimeInMinutes; });
 
         display.setAllProvider([&] { return timeReader.getDisplayString(); }
-                             , [&] { return logic.getMessage(); }
+                             , [&] { return String(logic.getMessage()); }
                              , [&] { return tempReader.getDisplayString(); }
                              , [&] { return parameterEditor.getDisplayString(); });
         relay.setProvider([&] { return byte{ ((logic.getCurrentStatus() == Status::heating) || (logic.getCurrentStatus() == Status::holding)) }; });
 		led.setProvider([&] { return logic.getCurrentStatus(); });
+
+        // the outputs are only written when one of the values they show changed
+        display.setInputs(timeReader.getChangeCounter(), logic.getChangeCounter(),
+                          tempReader.getChangeCounter(), parameterEditor.getChangeCounter());
+        relay.setInputs(logic.getChangeCounter());
+        led.setInputs(logic.getChangeCounter());
     }
 
-    void attach_start_condition(const StartConditions::ConditionFunction& condition)
+    // returns false if StartConditions::maxConditions conditions are attached already
+    // cost is the run time in microseconds used to order the conditions, measured if not given
+    bool attach_start_condition(const StartConditions::ConditionFunction& condition, unsigned long cost = StartConditions::measuredCost)
     {
-        startConditions.addCondition(condition);
+        return startConditions.addCondition(condition, cost);
     };
 
-    void attach_fault_condition(const FaultConditions::FaultCondition& condition, const String& message)
+    // message is a string literal, only the pointer is kept
+    // the rule is only checked in the given states, rules with a higher priority first
+    // returns false if FaultConditions::maxConditions rules are attached already, including the built-in ones
+    bool attach_fault_condition(const FaultConditions::FaultCondition& condition, const char* message,
+        FaultConditions::StateMask states = FaultConditions::allStates, uint8_t priority = FaultConditions::defaultPriority)
     {
-        faultConditions.addCondition(condition, message);
+        return logic.addFaultCondition(condition, message, states, priority);
 	};
 
+    // limits of the heating stall fault, see HaySteamerLogic::setHeatingStallLimits()
+    void setHeatingStallLimits(Temperature minRise, unsigned long window_ms) {
+        logic.setHeatingStallLimits(minRise, window_ms);
+    }
+
+    void setMissedRunPolicy(size_t taskIndex, MissedRunPolicy policy, uint8_t maxBurst = 3) {
+        if (taskIndex < tasks.size()) {
+            tasks[taskIndex]->setMissedRunPolicy(policy, maxBurst);
+        }
+    }
+
+    void setSkipTolerance(size_t taskIndex, unsigned long tolerance_ms) {
+        if (taskIndex < tasks.size()) {
+            tasks[taskIndex]->setSkipTolerance(tolerance_ms);
+        }
+    }
+
+    // reads the pressed key into the key queue, call from loop() when the keypad interrupt was signalled
+    // timeStamp is the time of the interrupt
+    // the fast input task is made due right away, so the key is processed in the next pass
+    void onKeyChanged(unsigned long timeStamp) {
+        if (keypadReader.readKey(timeStamp)) {
+            runNow(fastInputTask);
+        }
+    }
+
+    // time the outputs keep their fast cadence after the last edit, in ms
+    void setFastOutputWindow(unsigned long window_ms) {
+        fastOutputTrigger.setWindow(window_ms);
+    }
+
+    bool isFastOutputActive() const {
+        return outputTask.enabledFast;
+    }
+
+    // time from the key interrupt to the display write showing the key
+    const LatencyStatistics& getKeyEchoLatency() const {
+        return keyEchoProbe.getStatistics();
+    }
+
     void enableFastInputTask() {
         fastInputTask.enable();
 	};
@@ -234,19 +416,298 @@ public:
 		fastInputTask.disable();
 	};
 
+    // time stamp of the earliest scheduled task run
+    unsigned long nextDeadline() const {
+        return taskQueue.nextDeadline();
+    }
+
+    // true if at least one task is due, the main loop only needs to call executeCyclicTasks() then
+    bool isTaskDue(const unsigned long& currentTimeStamp) const {
+        return !taskQueue.empty() && isTimeReached(currentTimeStamp, taskQueue.nextDeadline());
+    }
+
+    // time in ms until the next task is due, 0 if a task is due already
+    unsigned long getTimeToNextDeadline(const unsigned long& currentTimeStamp) const {
+        if (taskQueue.empty() || isTimeReached(currentTimeStamp, taskQueue.nextDeadline())) {
+            return 0;
+        }
+        return taskQueue.nextDeadline() - currentTimeStamp;
+    }
+
+    // sleeps with the idle backend (WfiIdle, SandboxIdle) until the next task is due
+    // returns the time slept in ms, less if the backend was woken up by an interrupt
+    template<typename IdleBackend>
+    unsigned long idleUntilNextDeadline(IdleBackend& backend) const {
+        unsigned long idleTime = getTimeToNextDeadline(millis());
+        return idleTime ? backend.sleepFor(idleTime) : 0;
+    }
+
     // execute cyclic tasks with adaptive timing
+    // only the due tasks are taken from the deadline queue, they run in the order of the tasks array
+    // so inputs are still read before the logic and the logic runs before the outputs
     void executeCyclicTasks() {
         unsigned long currentMillis = millis();
+        unsigned long passStart = micros();
+        observedTime += passStart - lastPassStart;
+        lastPassStart = passStart;
+
+        uint32_t dueTasks = 0;
+        while (isTaskDue(currentMillis)) {
+            dueTasks |= (1UL << taskQueue.topSlot());
+            taskQueue.pop();
+        }
 
-        for (CyclicTask* task : tasks) {
+        // pipelined: a logic run takes a fresh sample and its outputs are written in the same pass,
+        // inputs and outputs not due by their own schedule run once more, their deadlines stay as they are
+        uint32_t pipelineRuns = 0;
+        if (pipelined && (dueTasks & (1UL << logicSlot))) {
+            pipelineRuns = pipelineSlots & ~dueTasks;
+        }
+
+        const unsigned long relayWrites = relay.getWriteCount();
+        for (uint8_t slot = 0; slot < tasks.size(); ++slot) {
+            CyclicTask* task = tasks[slot];
+            if (pipelineRuns & (1UL << slot)) {
+                runTask(slot, 0);
+                continue;
+            }
+            if (!(dueTasks & (1UL << slot))) {
+                continue;
+            }
+            unsigned long scheduledRun = task->nextRun;
             if (task->isRunScheduled(currentMillis)) {
-                task->cycleTask();
+                runTask(slot, currentMillis - scheduledRun);
             }
+            taskQueue.push(task, slot);
+        }
+
+        // sample to actuation: a relay write is caused by the last logic run
+        if (relay.getWriteCount() != relayWrites && logicSampleValid) {
+            actuationLatency.record(millis() - logicSampleTime);
         }
+
+        unsigned long passTime = micros() - passStart;
+        if (passTime > maxPassTime) maxPassTime = passTime;
+    }
+
+    // pipelined rate group: slow input, logic and output run in the same pass whenever the logic runs
+    // the slow input and output tasks take the phase of the logic task, so they are normally due together anyway
+    void setPipelined(bool enabled) {
+        pipelined = enabled;
+        if (pipelined) {
+            alignPipeline();
+        }
+    }
+
+    bool isPipelined() const {
+        return pipelined;
+    }
+
+    // time from the start of the temperature sample used by the logic to the end of the pass writing the relay, in ms
+    const LatencyStatistics& getActuationLatency() const {
+        return actuationLatency;
+    }
+
+    // phase offset of a task in ms, see CyclicTask::setPhaseOffset()
+    // when pipelined, moving the logic task moves the slow input and output tasks along
+    void setPhaseOffset(size_t taskIndex, unsigned long offset) {
+        if (taskIndex < tasks.size()) {
+            tasks[taskIndex]->setPhaseOffset(offset);
+            taskQueue.update(tasks[taskIndex]);
+        }
+        if (pipelined && taskIndex == logicSlot) {
+            alignPipeline();
+        }
+    }
+
+    unsigned long getPhaseOffset(size_t taskIndex) const {
+        return taskIndex < tasks.size() ? tasks[taskIndex]->phaseOffset : 0;
+    }
+
+    // load leveling: spreads the tasks over the schedule so that expensive tasks do not run in the same pass
+    // The schedule repeats after the least common multiple of the intervals and is divided into slots of their
+    // greatest common divisor (2000 ms in 100 ms slots with the default intervals). The most expensive task is placed
+    // first, every task gets the phase offset with the lowest peak slot load, using the measured worst case run times.
+    // When pipelined, the slow input and output tasks keep the phase of the logic task: the three are placed as one
+    // group with their summed cost, only the group as a whole is moved against the other tasks.
+    // Returns false if nothing was measured yet or the schedule has too many slots.
+    bool balanceTaskPhases() {
+        static const size_t maxSlots = 64;
+        unsigned long slotLength = tasks[0]->interval;
+        unsigned long hyperPeriod = tasks[0]->interval;
+        bool measured = false;
+        for (CyclicTask* task : tasks) {
+            slotLength = greatestCommonDivisor(slotLength, task->interval);
+            hyperPeriod = hyperPeriod / greatestCommonDivisor(hyperPeriod, task->interval) * task->interval;
+            measured |= task->statistics.runCount > 0;
+        }
+        const size_t slotCount = hyperPeriod / slotLength;
+        if (!measured || slotCount > maxSlots) {
+            return false;
+        }
+
+        // the tasks moved together with a task, the pipelined group for the logic task
+        auto groupOf = [&](size_t index) -> uint32_t {
+            return (pipelined && index == logicSlot) ? (pipelineSlots | (1UL << logicSlot)) : (1UL << index);
+        };
+        auto costOf = [&](size_t index) -> unsigned long {
+            return tasks[index]->statistics.runCount ? tasks[index]->statistics.maxRunTime : 0;
+        };
+        // cost the group adds to a slot with the given phase, false if none of its tasks runs in the slot
+        auto groupLoad = [&](uint32_t group, size_t phase, size_t slot, unsigned long& cost) {
+            bool runs = false;
+            cost = 0;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                const size_t period = tasks[i]->interval / slotLength;
+                if ((group & (1UL << i)) && slot % period == phase % period) {
+                    cost += costOf(i);
+                    runs = true;
+                }
+            }
+            return runs;
+        };
+
+        unsigned long load[maxSlots] = {};
+        uint32_t placed = pipelined ? (pipelineSlots & ~(1UL << logicSlot)) : 0;
+        for (size_t n = 0; n < tasks.size(); ++n) {
+            // most expensive task or group not placed yet
+            size_t index = 0;
+            unsigned long cost = 0;
+            bool found = false;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                if (placed & (1UL << i)) {
+                    continue;
+                }
+                unsigned long taskCost = 0;
+                for (size_t member = 0; member < tasks.size(); ++member) {
+                    if (groupOf(i) & (1UL << member)) taskCost += costOf(member);
+                }
+                if (!found || taskCost > cost) {
+                    index = i;
+                    cost = taskCost;
+                    found = true;
+                }
+            }
+            if (!found) {
+                break;
+            }
+            placed |= 1UL << index;
+
+            const uint32_t group = groupOf(index);
+            const size_t period = tasks[index]->interval / slotLength;
+            size_t bestPhase = 0;
+            unsigned long bestPeak = ~0UL;
+            for (size_t phase = 0; phase < period; ++phase) {
+                unsigned long peak = 0;
+                for (size_t slot = 0; slot < slotCount; ++slot) {
+                    unsigned long added = 0;
+                    if (groupLoad(group, phase, slot, added) && load[slot] + added > peak) peak = load[slot] + added;
+                }
+                if (peak < bestPeak) {
+                    bestPeak = peak;
+                    bestPhase = phase;
+                }
+            }
+            for (size_t slot = 0; slot < slotCount; ++slot) {
+                unsigned long added = 0;
+                groupLoad(group, bestPhase, slot, added);
+                load[slot] += added;
+            }
+            // moving the pipelined logic task moves its group along
+            setPhaseOffset(index, bestPhase * slotLength);
+        }
+        return true;
+    }
+
+    // longest executeCyclicTasks() pass since the last resetStatistics(), in microseconds
+    unsigned long getMaxPassTime() const {
+        return maxPassTime;
+    }
+
+    size_t getTaskCount() const {
+        return tasks.size();
+    }
+
+    const char* getTaskName(size_t index) const {
+        return index < tasks.size() ? taskNames[index] : "";
+    }
+
+    const TaskStatistics& getTaskStatistics(size_t index) const {
+        return tasks[index < tasks.size() ? index : 0]->statistics;
+    }
+
+    // share of the observed time spent in cycleTask() of all tasks, in percent
+    unsigned int getCpuLoadPercent() const {
+        unsigned long long observed = observedTime + (micros() - lastPassStart);
+        return observed ? static_cast<unsigned int>((busyTime * 100) / observed) : 0;
+    }
+
+    void resetStatistics() {
+        for (CyclicTask* task : tasks) {
+            task->statistics.reset();
+        }
+        keyEchoProbe.reset();
+        actuationLatency.reset();
+        maxPassTime = 0;
+        busyTime = 0;
+        observedTime = 0;
+        lastPassStart = micros();
     }
 
+    // one line per task: "name: runs N, us min/mean/max a/b/c, missed M, late ms h0 h1 ... h7"
+    String getStatisticsString(size_t index) const {
+        const TaskStatistics& stats = getTaskStatistics(index);
+        char buf[128];
+        int length = snprintf(buf, sizeof(buf), "%s: runs %lu, us min/mean/max %lu/%lu/%lu, missed %lu, late ms",
+            getTaskName(index), stats.runCount, stats.runCount ? stats.minRunTime : 0UL,
+            stats.getMeanRunTime(), stats.maxRunTime, stats.missedCycles);
+        for (uint8_t bucket = 0; bucket < TaskStatistics::latenessBuckets && length > 0 && length < (int)sizeof(buf); ++bucket) {
+            length += snprintf(buf + length, sizeof(buf) - length, " %lu", stats.latenessHistogram[bucket]);
+        }
+        return String(buf);
+    }
+
+#ifdef ARDUINO
+    // dump statistics of all tasks and the cpu load to Serial
+    void printStatistics() const {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            Serial.println(getStatisticsString(i));
+        }
+        Serial.print("cpu load %: ");
+        Serial.println(getCpuLoadPercent());
+        Serial.print("sample to relay ms mean/max: ");
+        Serial.print(actuationLatency.getMean());
+        Serial.print("/");
+        Serial.println(actuationLatency.count ? actuationLatency.max : 0UL);
+    }
+#endif
+
 public:
-	volatile bool startTimer = false;
+    // start times of the week with their parameters, checked once per logic run
+    StartSchedule& getSchedule() {
+        return schedule;
+    }
+
+    // temperatures read by the slow input task, kept by the time they were sampled
+    const TemperatureHistory& getHistory() const {
+        return history;
+    }
+
+    // inputs of the last logic run
+    const ProcessImage& getLogicProcessImage() const {
+        return logic.getProcessImage();
+    }
+
+    // state of the start button, may be called from an interrupt
+    // a press is latched until the next logic run, even if the button is released before
+    void setStartButton(bool pressed) {
+        IsrInputs inputs = isrInputs.lastWritten();
+        if (pressed && !inputs.startButton) {
+            ++inputs.startPresses;
+        }
+        inputs.startButton = pressed;
+        isrInputs.write(inputs);
+    }
 
 private:
     SlowInputTask slowInputTask;
@@ -254,25 +715,152 @@ private:
     LogicTask logicTask;
     OutputTask outputTask;
     std::array<CyclicTask*, 4> tasks{ &slowInputTask, &fastInputTask, &logicTask, &outputTask };
+    static_assert(std::tuple_size<decltype(tasks)>::value <= 32, "due tasks are collected in a 32 bit mask");
+    DeadlineQueue<CyclicTask, 4> taskQueue;
+    static constexpr const char* taskNames[4] = { "slow input", "fast input", "logic", "output" };
+
+    // cpu load, in microseconds
+    unsigned long long busyTime = 0;
+    unsigned long long observedTime = 0;
+    unsigned long lastPassStart = 0;
+    unsigned long maxPassTime = 0;
+
+    // pipelined rate group
+    static constexpr uint8_t slowInputSlot = 0;
+    static constexpr uint8_t logicSlot = 2;
+    static constexpr uint8_t outputSlot = 3;
+    static constexpr uint32_t pipelineSlots = (1UL << slowInputSlot) | (1UL << outputSlot);
+    bool pipelined = false;
+    unsigned long sampleTime = 0;
+    unsigned long logicSampleTime = 0;
+    bool logicSampleValid = false;
+    LatencyStatistics actuationLatency;
+
+    // runs a task and records its statistics, tracks the sample time used by the logic
+    void runTask(uint8_t slot, unsigned long lateness) {
+        CyclicTask* task = tasks[slot];
+        if (slot == logicSlot) {
+            logicSampleTime = sampleTime;
+            logicSampleValid = true;
+        }
+        unsigned long runStart = micros();
+        task->cycleTask();
+        if (slot == slowInputSlot) {
+            // collected by the sampler before the task ran, or read right now by a plain sensor
+            sampleTime = tempReader.getSampleTime();
+            history.add(sampleTime, tempReader.getLatestValue());
+        }
+        unsigned long runTime = micros() - runStart;
+        busyTime += runTime;
+        task->statistics.recordRun(runTime, lateness);
+    }
+
+    void alignPipeline() {
+        setPhaseOffset(slowInputSlot, logicTask.phaseOffset);
+        setPhaseOffset(outputSlot, logicTask.phaseOffset);
+    }
+
+    static unsigned long greatestCommonDivisor(unsigned long a, unsigned long b) {
+        while (b) {
+            unsigned long rest = a % b;
+            a = b;
+            b = rest;
+        }
+        return a;
+    }
+
+    // weekly start schedule and the slot of the current run
+    StartSchedule schedule;
+    ScheduleSlot scheduledRun{};
+    bool isScheduledRun = false;
+
+    // inputs written by interrupts, read once per logic run
+    DoubleBuffer<IsrInputs> isrInputs;
+    uint16_t capturedStartPresses = 0;
+
+    void captureProcessImage(ProcessImage& image) {
+        const IsrInputs inputs = isrInputs.read();
+        image.startButton = inputs.startButton || inputs.startPresses != capturedStartPresses;
+        capturedStartPresses = inputs.startPresses;
+
+        image.timeStamp = millis();
+        image.timeOfDayInMinutes = timeReader.getTimeOfDayInMinutes();
+        image.minuteOfWeek = timeReader.getMinuteOfWeek();
+        static_assert(ProcessImage::maxProbes >= maxTempProbes, "every probe fits into the process image");
+        image.temperature = tempReader.getLatestValue();
+        image.probeCount = tempReader.getProbeCount();
+        for (uint8_t probe = 0; probe < image.probeCount; ++probe) {
+            image.temperatures[probe] = tempReader.getProbe(probe).value;
+        }
+        image.failedProbes = tempReader.getFailedProbes();
+        image.probesDisagree = tempReader.probesDisagree();
+        image.lastKey = keypadReader.getLatestValue();
+        image.startTimeInMinutes = parameterEditor.getTimeInMinutes();
+        image.minimumTemperature = Temperature::fromCelsius(parameterEditor.getTemperature());
+        image.waitTime = parameterEditor.getTimeSpan();
+
+        // a reached slot starts a run with its parameters, they apply until the process is idle again
+        // a slot reached while a run is going on is skipped
+        const ScheduleSlot* reached = schedule.poll(image.minuteOfWeek);
+        const bool isIdle = logic.getCurrentStatus() == Status::idle;
+        if (reached && isIdle) {
+            scheduledRun = *reached;
+            isScheduledRun = true;
+        }
+        else if (isIdle || logic.getCurrentStatus() == Status::error) {
+            isScheduledRun = false;
+        }
+        image.scheduledStart = isScheduledRun;
+        if (isScheduledRun) {
+            image.minimumTemperature = Temperature::fromCelsius(scheduledRun.temperature);
+            image.waitTime = scheduledRun.timeSpan;
+        }
+    }
+
+    // makes a queued task due at the current time
+    void runNow(CyclicTask& task) {
+        task.nextRun = millis();
+        taskQueue.update(&task);
+    }
+
+    // output task to fast cadence, the next output run is due right away
+    void enableFastOutput() {
+        outputTask.enableFast();
+        runNow(outputTask);
+    }
+
+    void queueAllTasks() {
+        taskQueue.clear();
+        for (uint8_t slot = 0; slot < tasks.size(); ++slot) {
+            taskQueue.push(tasks[slot], slot);
+        }
+    }
 
 	// modules in slow input task
-    TimeReader timeReader;
-    TempReader tempReader;
+    BasicTimeReader<ClockType> timeReader;
+    BasicTempReader<TempType> tempReader;
+    TemperatureHistory history;
+
+	// read on the keypad interrupt
+    BasicKeypadReader<KeypadType> keypadReader;
 
 	// modules in fast input task
-    KeypadReader keypadReader;
     ParameterEditor parameterEditor;
 
     // modules in logic task
     HaySteamerLogic logic;
 	StartConditions startConditions;
-	FaultConditions faultConditions;
+
+	FastOutputTrigger fastOutputTrigger;
 
 	// modules in output task
-    DisplayWriter display;
-	RelayWriter relay;
-	LEDWriter led;
+    BasicDisplayWriter<DisplayType> display;
+	BasicRelayWriter<RelayType> relay;
+	BasicLEDWriter<LedType> led;
+	KeyEchoProbe keyEchoProbe;
 	
 };
 
+using CyclicCaller = BasicCyclicCaller<NTPClock, TempSensor, keypad_input, Display126x64, relay_output, LED>;
+
 #endif
@@ -1,10 +1,16 @@
 #ifndef TEMPREADER_H
 #define TEMPREADER_H
 
+#include "ChangeTracking.h"
+#include "DeadlineQueue.h"
+#include "ProbeFusion.h"
+#include "Temperature.h"
+
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
 
 #include "Sandbox/StringConversion.h"
+#include "Sandbox/millis.h"
 #include "Sandbox/Sensor.h"
 #include "Sandbox/Status.h"
 #include "Sandbox/CyclicModule.h"
@@ -20,13 +26,22 @@
 #define toString(x) String(x)
 #endif
 
-using TempSensor = Sensor<int>;
+using TempSensor = Sensor<Temperature>;
 
-class TempReader : public CyclicModule {
+/// <summary>
+/// Reads the temperature sensor. SensorType is the interface TempSensor or,
+/// if the hardware is known at compile time, the concrete sensor class, which lets the compiler inline read().
+/// A sensor with several probes (see ProbeSampler) also hands out every probe, any other sensor counts as one probe.
+/// </summary>
+template<typename SensorType>
+class BasicTempReader : public CyclicModule {
 public:
+    // a probe without a new sample for this many conversion times has failed, e.g. the sampler is no longer polled
+    static constexpr unsigned long probeTimeoutConversions = 10;
+
     // No interval parameter needed anymore
-    TempReader(TempSensor* sensor)
-        : sensor(sensor), lastValue(0) {
+    BasicTempReader(SensorType* sensor)
+        : sensor(sensor) {
     }
 
 	/// <summary>
@@ -34,35 +49,114 @@ public:
 	/// It should be called periodically to keep the lastValue updated.
 	/// </summary>
     void update() override {
-        lastValue = sensor->read();
+        const unsigned long readStart = millis();
+        changes.publish(lastValue, sensor->read());
+        readProbes(sensor, readStart, 0);
     }
 
 	/// <summary>
-	/// Returns the last read temperature value in C.
+	/// Returns the last read temperature value.
 	/// </summary>
-	/// <returns>Last temperature value in C.</returns>
-    int getLatestValue() const {
+	/// <returns>Last temperature value, in hundredths of a degree.</returns>
+    Temperature getLatestValue() const {
         return lastValue;
     }
 
+    /// <summary>
+    /// Number of probes of the sensor, 1 for a sensor without probes.
+    /// </summary>
+    uint8_t getProbeCount() const {
+        return probeCount;
+    }
+
+    /// <summary>
+    /// Last sample of one probe, the fused value for a sensor without probes.
+    /// </summary>
+    const ProbeSample& getProbe(uint8_t probe) const {
+        return probes[probe];
+    }
+
+    /// <summary>
+    /// millis() when the oldest valid probe sample of the latest value was collected,
+    /// the start of the read for a sensor without probes.
+    /// </summary>
+    unsigned long getSampleTime() const {
+        return sampleTime;
+    }
+
+    /// <summary>
+    /// One bit per probe that has failed: its last sample is not valid (e.g. an open thermocouple)
+    /// or older than probeTimeoutConversions conversion times. Always 0 for a sensor without probes.
+    /// </summary>
+    uint8_t getFailedProbes() const {
+        return failedProbes;
+    }
+
+    /// <summary>
+    /// True if the fusion rejected a probe or the probes differ by more than the outlier limit.
+    /// </summary>
+    bool probesDisagree() const {
+        return disagreement;
+    }
+
+    /// <summary>
+	/// Version of the temperature value, changes whenever a different value is read.
+	/// </summary>
+    const ChangeCounter& getChangeCounter() const {
+        return changes;
+    }
+
 	/// <summary>
-	/// Get the latest value as string ("TTTC"), always 6 characters long,
-	/// where TTT is the temperature in C.
+	/// Get the latest value as string ("TTT.TC"), always 6 characters long,
+	/// where TTT.T is the temperature in C, rounded to a tenth.
 	/// </summary>
 	/// <returns>String representation of the last temperature value.</returns>
     String getDisplayString() const {
-        String result = "";
-        if (lastValue < -9) result += "";
-		else if (lastValue < 0) result += " ";
-		else if (lastValue < 10) result += "  ";
-        else if (lastValue < 100) result += " ";
-        result += toString(lastValue) + "C";
-        return result;
+        char text[Temperature::displayLength + 1];
+        lastValue.format(text);
+        return String(text);
     }
 
 private:
-    TempSensor* sensor;
-    int lastValue;
+    // chosen if the sensor has probes
+    template<typename S>
+    auto readProbes(S* probeSensor, unsigned long readStart, int) -> decltype(probeSensor->getProbeCount(), probeSensor->getSample(0), probeSensor->getFusionResult(), probeSensor->getConversionTime(), void()) {
+        probeCount = probeSensor->getProbeCount();
+        const unsigned long timeout = probeTimeoutConversions * probeSensor->getConversionTime();
+        failedProbes = 0;
+        // the value is as old as its oldest sample, without a valid sample the sensor keeps the last value and its time
+        bool anyValid = false;
+        for (uint8_t probe = 0; probe < probeCount; ++probe) {
+            probes[probe] = probeSensor->getSample(probe);
+            if (probes[probe].valid && (!anyValid || isTimeReached(sampleTime, probes[probe].timeStamp))) {
+                sampleTime = probes[probe].timeStamp;
+                anyValid = true;
+            }
+            if (!probes[probe].valid || readStart - probes[probe].timeStamp > timeout) {
+                failedProbes |= static_cast<uint8_t>(1u << probe);
+            }
+        }
+        disagreement = probeSensor->getFusionResult().disagreement;
+    }
+
+    template<typename S>
+    void readProbes(S*, unsigned long readStart, long) {
+        probes[0].value = lastValue;
+        probes[0].valid = true;
+        probes[0].timeStamp = readStart;
+        sampleTime = readStart;
+    }
+
+    SensorType* sensor;
+    Temperature lastValue;
+    ChangeCounter changes;
+    ProbeSample probes[maxTempProbes] = {};
+    uint8_t probeCount = 1;
+    uint8_t failedProbes = 0;
+    bool disagreement = false;
+    unsigned long sampleTime = 0;
 };
 
+using TempReader = BasicTempReader<TempSensor>;
+
 #endif
@@ -0,0 +1,96 @@
+#ifndef TEMPERATURE_H
+#define TEMPERATURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Temperature in hundredths of a degree celsius. The arithmetic is integer only, no float on the way from
+/// the probes to the logic, and the 0.25 degree steps of the MAX6675 are kept. Write constants as 60_degC or 60.5_degC.
+/// </summary>
+class Temperature {
+public:
+    static constexpr long perDegree = 100;
+    static constexpr size_t displayLength = 6;     // "TTT.TC"
+
+    constexpr Temperature() = default;
+
+    static constexpr Temperature fromCentiCelsius(long centiCelsius) { return Temperature(centiCelsius); }
+    static constexpr Temperature fromCelsius(long degrees) { return Temperature(degrees * perDegree); }
+    // from counts of a probe, e.g. quarter degrees with countsPerDegree 4, rounded to the nearest hundredth
+    static constexpr Temperature fromCounts(long counts, long countsPerDegree)
+    {
+        return Temperature(roundedDivision(counts * perDegree, countsPerDegree));
+    }
+
+    constexpr long centiCelsius() const { return centi; }
+    // rounded to the nearest degree
+    constexpr long wholeDegrees() const { return roundedDivision(centi, perDegree); }
+
+    constexpr Temperature operator+(Temperature other) const { return Temperature(centi + other.centi); }
+    constexpr Temperature operator-(Temperature other) const { return Temperature(centi - other.centi); }
+    constexpr Temperature operator-() const { return Temperature(-centi); }
+    constexpr Temperature operator*(long factor) const { return Temperature(centi * factor); }
+    constexpr Temperature operator/(long divisor) const { return Temperature(roundedDivision(centi, divisor)); }
+    Temperature& operator+=(Temperature other) { centi += other.centi; return *this; }
+    Temperature& operator-=(Temperature other) { centi -= other.centi; return *this; }
+
+    constexpr bool operator==(Temperature other) const { return centi == other.centi; }
+    constexpr bool operator!=(Temperature other) const { return centi != other.centi; }
+    constexpr bool operator<(Temperature other) const { return centi < other.centi; }
+    constexpr bool operator<=(Temperature other) const { return centi <= other.centi; }
+    constexpr bool operator>(Temperature other) const { return centi > other.centi; }
+    constexpr bool operator>=(Temperature other) const { return centi >= other.centi; }
+
+    /// <summary>
+    /// Writes "TTT.TC", always displayLength characters and a terminating zero, rounded to a tenth,
+    /// from "-99.9C" to "999.9C".
+    /// </summary>
+    void format(char (&text)[displayLength + 1]) const
+    {
+        long tenths = roundedDivision(centi, 10);
+        if (tenths < -999) tenths = -999;
+        if (tenths > 9999) tenths = 9999;
+        const bool negative = tenths < 0;
+        unsigned long digits = negative ? -tenths : tenths;
+
+        text[displayLength] = '\0';
+        text[5] = 'C';
+        text[4] = static_cast<char>('0' + digits % 10);
+        text[3] = '.';
+        digits /= 10;
+        int position = 2;
+        do {
+            text[position--] = static_cast<char>('0' + digits % 10);
+            digits /= 10;
+        } while (digits > 0 && position >= 0);
+        if (negative) text[position--] = '-';
+        while (position >= 0) text[position--] = ' ';
+    }
+
+private:
+    explicit constexpr Temperature(long centiCelsius) : centi(centiCelsius) {}
+
+    static constexpr long roundedDivision(long value, long divisor)
+    {
+        return (value >= 0) == (divisor >= 0) ? (value + divisor / 2) / divisor : (value - divisor / 2) / divisor;
+    }
+
+    long centi = 0;
+};
+
+constexpr Temperature operator""_degC(unsigned long long degrees)
+{
+    return Temperature::fromCelsius(static_cast<long>(degrees));
+}
+
+constexpr Temperature operator""_degC(long double degrees)
+{
+    return Temperature::fromCentiCelsius(static_cast<long>(degrees * Temperature::perDegree + (degrees < 0 ? -0.5L : 0.5L)));
+}
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef TEMPERATUREHISTORY_H
+#define TEMPERATUREHISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Temperature.h"
+#include "DeadlineQueue.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// One entry of the history: the lowest, highest and mean temperature of the samples taken in a period,
+/// timeStamp is millis() at the start of the period. A single sample has all three equal.
+/// A period without samples is kept as an entry that is not valid, its temperatures are 0.
+/// </summary>
+struct HistoryPoint {
+    unsigned long timeStamp = 0;
+    Temperature minimum;
+    Temperature maximum;
+    Temperature mean;
+    bool valid = true;
+};
+
+/// <summary>
+/// Collects the samples of one period of a tier: minimum, maximum and a running sum for the mean,
+/// updated with every sample, so rolling up never looks at the stored entries again.
+/// </summary>
+class HistoryRollup {
+public:
+    void add(Temperature minimum, Temperature maximum, Temperature mean)
+    {
+        if (count == 0 || minimum < lowest) lowest = minimum;
+        if (count == 0 || maximum > highest) highest = maximum;
+        sum += mean;
+        ++count;
+    }
+
+    void add(Temperature value) { add(value, value, value); }
+
+    uint16_t getCount() const { return count; }
+    Temperature getMinimum() const { return lowest; }
+    Temperature getMaximum() const { return highest; }
+    Temperature getMean() const { return count ? sum / count : Temperature(); }
+
+    void clear() { *this = HistoryRollup(); }
+
+private:
+    Temperature lowest;
+    Temperature highest;
+    Temperature sum;    // every added mean stands for the same number of samples, their mean is the mean of all
+    uint16_t count = 0;
+};
+
+/// <summary>
+/// Stored form of a sample, 2 bytes. Hundredths of a degree in 16 bit, clamped to -327.67..327.67 C,
+/// which keeps the quarter degrees of the probes and is far beyond what a bale reaches.
+/// -327.68 C marks a period without samples.
+/// </summary>
+struct PackedSample {
+    static constexpr int16_t noSample = INT16_MIN;
+
+    int16_t value = noSample;
+
+    void store(const HistoryRollup& rollup) { value = pack(rollup.getMean()); }
+    void clear() { value = noSample; }
+    bool empty() const { return value == noSample; }
+    Temperature minimum() const { return unpack(value); }
+    Temperature maximum() const { return unpack(value); }
+    Temperature mean() const { return unpack(value); }
+
+    static int16_t pack(Temperature temperature)
+    {
+        const long centi = temperature.centiCelsius();
+        return static_cast<int16_t>(centi <= noSample ? noSample + 1 : (centi > INT16_MAX ? INT16_MAX : centi));
+    }
+
+    static Temperature unpack(int16_t centi) { return Temperature::fromCentiCelsius(centi); }
+};
+
+/// <summary>
+/// Stored form of a rolled up period, 6 bytes.
+/// </summary>
+struct PackedAggregate {
+    int16_t lowest = PackedSample::noSample;
+    int16_t highest = PackedSample::noSample;
+    int16_t average = PackedSample::noSample;
+
+    void store(const HistoryRollup& rollup)
+    {
+        lowest = PackedSample::pack(rollup.getMinimum());
+        highest = PackedSample::pack(rollup.getMaximum());
+        average = PackedSample::pack(rollup.getMean());
+    }
+    void clear() { lowest = highest = average = PackedSample::noSample; }
+    bool empty() const { return average == PackedSample::noSample; }
+    Temperature minimum() const { return PackedSample::unpack(lowest); }
+    Temperature maximum() const { return PackedSample::unpack(highest); }
+    Temperature mean() const { return PackedSample::unpack(average); }
+};
+
+/// <summary>
+/// Ring buffer of the last Capacity entries, one per Period_ms. Only the time of the newest entry is stored,
+/// the older ones are Period_ms apart, so an entry costs just its packed temperatures.
+/// Periods skipped between two added entries are stored as empty entries to keep that spacing.
+/// Adding overwrites the oldest entry when the buffer is full, O(1) plus the skipped periods, at most Capacity.
+/// </summary>
+template<typename Entry, size_t Capacity, unsigned long Period_ms>
+class HistoryTier {
+public:
+    static_assert(Capacity > 0, "a tier holds at least one entry");
+    static_assert(Period_ms > 0, "a tier needs a period");
+    static constexpr size_t capacity = Capacity;
+    static constexpr unsigned long period_ms = Period_ms;
+    static constexpr unsigned long span_ms = Capacity * Period_ms;
+
+    class Iterator {
+    public:
+        Iterator(const HistoryTier* tier, size_t age, size_t remaining) : tier(tier), age(age), remaining(remaining) {}
+
+        HistoryPoint operator*() const { return tier->at(age); }
+        Iterator& operator++() { --age; --remaining; return *this; }
+        bool operator==(const Iterator& other) const { return remaining == other.remaining; }
+        bool operator!=(const Iterator& other) const { return remaining != other.remaining; }
+
+    private:
+        const HistoryTier* tier;
+        size_t age;
+        size_t remaining;
+    };
+
+    /// <summary>
+    /// Entries of a query, oldest first.
+    /// </summary>
+    class Range {
+    public:
+        Range(const HistoryTier* tier, size_t oldestAge, size_t count) : tier(tier), oldestAge(oldestAge), count(count) {}
+
+        Iterator begin() const { return Iterator(tier, oldestAge, count); }
+        Iterator end() const { return Iterator(tier, oldestAge - count, 0); }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+    private:
+        const HistoryTier* tier;
+        size_t oldestAge;
+        size_t count;
+    };
+
+    /// <summary>
+    /// Adds the entry of the period starting at timeStamp, which is a whole number of periods after the newest entry.
+    /// </summary>
+    void add(unsigned long timeStamp, const HistoryRollup& rollup)
+    {
+        if (count > 0 && !isTimeReached(newestTime, timeStamp)) {
+            unsigned long skipped = (timeStamp - newestTime) / Period_ms - 1;
+            if (skipped > Capacity) skipped = Capacity;
+            for (; skipped > 0; --skipped) {
+                entries[next].clear();
+                advance();
+            }
+        }
+        entries[next].store(rollup);
+        advance();
+        newestTime = timeStamp;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /// <summary>
+    /// Entry by age, 0 is the newest, size() - 1 the oldest.
+    /// </summary>
+    HistoryPoint at(size_t age) const
+    {
+        const Entry& entry = entries[(next + Capacity - 1 - age) % Capacity];
+        HistoryPoint point;
+        point.timeStamp = newestTime - age * Period_ms;
+        point.valid = !entry.empty();
+        if (point.valid) {
+            point.minimum = entry.minimum();
+            point.maximum = entry.maximum();
+            point.mean = entry.mean();
+        }
+        return point;
+    }
+
+    /// <summary>
+    /// Entries with from &lt;= timeStamp &lt;= to, oldest first. The times are compared as differences to the newest entry,
+    /// so a query works across the millis() wraparound as long as it reaches back less than 24 days.
+    /// </summary>
+    Range query(unsigned long from, unsigned long to) const
+    {
+        const long toNewest = static_cast<long>(newestTime - to);
+        const long fromNewest = static_cast<long>(newestTime - from);
+        if (count == 0 || fromNewest < 0 || fromNewest < toNewest) {
+            return Range(this, 0, 0);
+        }
+        const size_t newestAge = toNewest <= 0 ? 0 : (static_cast<unsigned long>(toNewest) + Period_ms - 1) / Period_ms;
+        size_t oldestAge = static_cast<unsigned long>(fromNewest) / Period_ms;
+        if (oldestAge > count - 1) oldestAge = count - 1;
+        if (newestAge > oldestAge) {
+            return Range(this, 0, 0);
+        }
+        return Range(this, oldestAge, oldestAge - newestAge + 1);
+    }
+
+    /// <summary>
+    /// The entries of the last duration_ms, the newest one included, e.g. last(60000) are the last 60 seconds.
+    /// </summary>
+    Range last(unsigned long duration_ms) const
+    {
+        return query(newestTime - duration_ms + 1, newestTime);
+    }
+
+    void clear()
+    {
+        next = 0;
+        count = 0;
+    }
+
+private:
+    void advance()
+    {
+        next = (next + 1) % Capacity;
+        if (count < Capacity) ++count;
+    }
+
+    Entry entries[Capacity] = {};
+    size_t next = 0;
+    size_t count = 0;
+    unsigned long newestTime = 0;
+};
+
+/// <summary>
+/// Collects the samples of the open period of a tier and stores it in the tier when a sample of a later period comes in.
+/// The periods are aligned to multiples of Period_ms of millis(), so the periods of the tiers start together.
+/// A sample older than the open period counts into the open period.
+/// </summary>
+template<typename Tier>
+class PeriodCollector {
+public:
+    void add(Tier& tier, unsigned long timeStamp, Temperature value)
+    {
+        if (!started) {
+            started = true;
+            periodStart = timeStamp - timeStamp % Tier::period_ms;
+        }
+        else if (isTimeReached(timeStamp, periodStart + Tier::period_ms)) {
+            tier.add(periodStart, rollup);
+            rollup.clear();
+            periodStart += (timeStamp - periodStart) / Tier::period_ms * Tier::period_ms;
+        }
+        rollup.add(value);
+    }
+
+    void clear()
+    {
+        rollup.clear();
+        started = false;
+    }
+
+private:
+    HistoryRollup rollup;
+    unsigned long periodStart = 0;
+    bool started = false;
+};
+
+/// <summary>
+/// Temperature history in three tiers: recent samples, the 5 minute periods of a day and the hours of a week.
+/// Every tier collects the samples of its open period in a HistoryRollup and stores the period when the time
+/// of a sample crosses into a later one, so the entries follow the sample times: a burst of samples in one period
+/// is one entry, a period without samples is an empty entry. add() stores at most one entry per tier and never
+/// walks a buffer, except over skipped periods. The newest, still open period of every tier is not stored yet.
+/// The slow input task calls add() with the time its temperature was sampled, about every second.
+/// </summary>
+template<typename RecentTier, typename DayTier, typename WeekTier>
+class BasicTemperatureHistory {
+public:
+    static_assert(DayTier::period_ms % RecentTier::period_ms == 0, "a day entry spans whole recent entries");
+    static_assert(WeekTier::period_ms % DayTier::period_ms == 0, "a week entry spans whole day entries");
+
+    void add(unsigned long timeStamp, Temperature value)
+    {
+        recentCollector.add(recentTier, timeStamp, value);
+        dayCollector.add(dayTier, timeStamp, value);
+        weekCollector.add(weekTier, timeStamp, value);
+    }
+
+    const RecentTier& recent() const { return recentTier; }
+    const DayTier& day() const { return dayTier; }
+    const WeekTier& week() const { return weekTier; }
+
+    void clear()
+    {
+        recentTier.clear();
+        dayTier.clear();
+        weekTier.clear();
+        recentCollector.clear();
+        dayCollector.clear();
+        weekCollector.clear();
+    }
+
+private:
+    RecentTier recentTier;
+    DayTier dayTier;
+    WeekTier weekTier;
+    PeriodCollector<RecentTier> recentCollector;
+    PeriodCollector<DayTier> dayCollector;
+    PeriodCollector<WeekTier> weekCollector;
+};
+
+// 1 s samples for 10 minutes (1.2 KB), 5 minute entries for a day (1.7 KB), hourly entries for a week (1 KB)
+using TemperatureHistory = BasicTemperatureHistory<
+    HistoryTier<PackedSample, 600, 1000UL>,
+    HistoryTier<PackedAggregate, 288, 5UL * 60000UL>,
+    HistoryTier<PackedAggregate, 168, 60UL * 60000UL>>;
+
+#endif
@@ -1,18 +1,26 @@
 #include "TimeReader.h"
 
-TimeReader::TimeReader(NTPClock* clock)
-    : clock(clock), lastValue(0) {
+void TimeReaderBase::setTime(time_t time) {
+    if (time / 60 != lastValue / 60) {
+        changes.markChanged();
+    }
+    lastValue = time;
 };
 
-void TimeReader::update() {
-    lastValue = clock->read();
+int TimeReaderBase::getTimeOfDayInMinutes() const {
+    return ((lastValue / 60) % 1440);
 };
 
-int TimeReader::getTimeOfDayInMinutes() const {
-    return ((lastValue / 60) % 1440);
+uint8_t TimeReaderBase::getWeekday() const {
+    // 1970-01-01 was a thursday
+    return ((lastValue / 86400 + 3) % 7) + 1;
+};
+
+unsigned long TimeReaderBase::getMinuteOfWeek() const {
+    return (getWeekday() - 1) * 1440UL + getTimeOfDayInMinutes();
 };
 
-String TimeReader::getDisplayString() const {
+String TimeReaderBase::getDisplayString() const {
     char buf[18];
     TimeElements tm = breakTime(lastValue);
     snprintf(buf, sizeof(buf), "%02d:%02d %02d.%02d.%04d",
@@ -20,7 +28,7 @@ String TimeReader::getDisplayString() const {
     return String(buf);
 };
 
-TimeReader::TimeElements TimeReader::breakTime(time_t timeInput) const {
+TimeReaderBase::TimeElements TimeReaderBase::breakTime(time_t timeInput) const {
     // break the given time_t into time components
     // this is a more compact version of the C library localtime function
     // note that year is offset from 1970
@@ -1,6 +1,8 @@
 #ifndef TIMEREADER_H
 #define TIMEREADER_H
 
+#include "ChangeTracking.h"
+
 #ifdef SANDBOX_ENVIRONMENT
 #pragma once
 
@@ -21,23 +23,33 @@
 
 using NTPClock = Sensor<time_t>;
 
-class TimeReader : public CyclicModule {
+/// Conversion and formatting of the last read ntp time, independent of the clock type.
+class TimeReaderBase : public CyclicModule {
 public:
-    TimeReader(NTPClock* clock);
-
-    /// Updates the lastValue with the current ntp time
-    /// It should be called periodically to keep the lastValue updated.
-    void update() override;
-
     /// Returns the time of day in minutes converted from the last read of the ntp clock
     /// <returns>time of day in minutes</returns>
     int getTimeOfDayInMinutes() const;
 
+    /// Day of the week of the last read, like TimeElements::Wday
+    /// <returns>1 for monday to 7 for sunday</returns>
+    uint8_t getWeekday() const;
+
+    /// Minutes since monday 00:00 of the last read
+    /// <returns>minute of the week, 0 to 7 * 1440 - 1</returns>
+    unsigned long getMinuteOfWeek() const;
+
     /// Get the current date and time as string ("hh:mm dd.mm.yyyy")
     /// in 24h format
     /// <returns>String representation of the last time and date</returns>
     String getDisplayString() const;
 
+    /// Version of the time, changes once per minute, i.e. whenever the display string changes
+    const ChangeCounter& getChangeCounter() const { return changes; }
+
+protected:
+    /// Stores the time read from the clock
+    void setTime(time_t time);
+
 private:
     struct TimeElements {
         uint8_t Second; // 0-59
@@ -56,9 +68,30 @@ private:
     constexpr static uint8_t monthDays[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
 
     TimeElements breakTime(time_t timeInput) const;
-    
-    NTPClock* clock;
-	time_t lastValue; // in seconds since epoch (1970-01-01 00:00:00 UTC), converted to local time
+
+	time_t lastValue = 0; // in seconds since epoch (1970-01-01 00:00:00 UTC), converted to local time
+    ChangeCounter changes;
 };
 
+/// Reads the ntp clock. ClockType is the interface NTPClock or,
+/// if the hardware is known at compile time, the concrete clock class, which lets the compiler inline read().
+template<typename ClockType>
+class BasicTimeReader : public TimeReaderBase {
+public:
+    BasicTimeReader(ClockType* clock)
+        : clock(clock) {
+    }
+
+    /// Updates the lastValue with the current ntp time
+    /// It should be called periodically to keep the lastValue updated.
+    void update() override {
+        setTime(clock->read());
+    }
+
+private:
+    ClockType* clock;
+};
+
+using TimeReader = BasicTimeReader<NTPClock>;
+
 #endif
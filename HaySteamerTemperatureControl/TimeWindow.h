@@ -0,0 +1,36 @@
+#ifndef TIMEWINDOW_H
+#define TIMEWINDOW_H
+
+#include <stdint.h>
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Window of the day given by its start and length in minutes, may run over midnight.
+/// contains() works on the distance from the start modulo one day, so 23:30 + 60 minutes contains 00:15.
+/// </summary>
+struct TimeWindow {
+    static constexpr unsigned long minutesPerDay = 24UL * 60;
+
+    constexpr TimeWindow(unsigned long startMinute, unsigned long lengthMinutes)
+        : start(startMinute % minutesPerDay), length(lengthMinutes < minutesPerDay ? lengthMinutes : minutesPerDay)
+    { }
+
+    // minutes from the start of the window to the time of day, 0 to minutesPerDay - 1
+    static constexpr unsigned long minutesSince(unsigned long startMinute, unsigned long timeOfDayInMinutes) {
+        return (timeOfDayInMinutes % minutesPerDay + minutesPerDay - startMinute % minutesPerDay) % minutesPerDay;
+    }
+
+    constexpr bool contains(unsigned long timeOfDayInMinutes) const {
+        return minutesSince(start, timeOfDayInMinutes) < length;
+    }
+
+    constexpr unsigned long end() const { return (start + length) % minutesPerDay; }
+
+    unsigned long start;
+    unsigned long length;
+};
+
+#endif
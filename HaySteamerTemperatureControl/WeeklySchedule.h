@@ -0,0 +1,163 @@
+#ifndef WEEKLYSCHEDULE_H
+#define WEEKLYSCHEDULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TimeWindow.h"
+#include "ParameterEditor.h"
+
+#ifdef SANDBOX_ENVIRONMENT
+#pragma once
+#endif
+
+/// <summary>
+/// Start of a steaming run at a minute of the week, with its own parameters.
+/// </summary>
+struct ScheduleSlot {
+    uint16_t minuteOfWeek;      // 0 is monday 00:00
+    int temperature;            // minimum temperature in degree celsius
+    uint16_t timeSpan;          // holding time in minutes
+};
+
+/// <summary>
+/// Start times of the week, several per day, kept sorted by the minute of the week.
+/// Only the next start is armed: poll() compares the time with it and re-arms the following start
+/// by a binary search when it was reached, the table is not scanned on every call.
+/// </summary>
+template<size_t Capacity>
+class WeeklySchedule {
+public:
+    static constexpr unsigned long minutesPerWeek = 7 * TimeWindow::minutesPerDay;
+    static constexpr uint8_t allDays = 0x7F;                      // bit 0 is monday
+    static constexpr uint8_t workDays = 0x1F;
+    static constexpr uint8_t weekend = 0x60;
+
+    static constexpr unsigned long toMinuteOfWeek(uint8_t weekday, unsigned long minuteOfDay) {
+        return ((weekday - 1) % 7) * TimeWindow::minutesPerDay + minuteOfDay % TimeWindow::minutesPerDay;
+    }
+
+    /// <summary>
+    /// True if a start with these parameters could also be entered at the keypad:
+    /// weekday 1 to 7, a minute of the day, temperature and holding time within the limits of the parameter editor,
+    /// and a holding time of at least one minute.
+    /// </summary>
+    static constexpr bool isValidSlot(uint8_t weekday, unsigned long minuteOfDay, int temperature, unsigned long timeSpan) {
+        return weekday >= 1 && weekday <= 7
+            && minuteOfDay < TimeWindow::minutesPerDay
+            && temperature >= 0 && temperature <= MAX_TEMPERATURE
+            && timeSpan > 0 && timeSpan <= static_cast<unsigned long>(MAX_SPAN);
+    }
+
+    /// <summary>
+    /// Adds a start on a weekday (1 is monday, like TimeElements::Wday).
+    /// </summary>
+    /// <returns>false if the schedule is full or the slot is not valid, see isValidSlot()</returns>
+    bool addSlot(uint8_t weekday, unsigned long minuteOfDay, int temperature, unsigned long timeSpan) {
+        if (count >= Capacity || !isValidSlot(weekday, minuteOfDay, temperature, timeSpan)) {
+            return false;
+        }
+        const ScheduleSlot slot{ static_cast<uint16_t>(toMinuteOfWeek(weekday, minuteOfDay)), temperature, static_cast<uint16_t>(timeSpan) };
+        size_t i = count++;
+        while (i > 0 && slots[i - 1].minuteOfWeek > slot.minuteOfWeek) {
+            slots[i] = slots[i - 1];
+            --i;
+        }
+        slots[i] = slot;
+        armed = false;
+        return true;
+    }
+
+    /// <summary>
+    /// Adds the same start on every day of the days mask.
+    /// </summary>
+    /// <returns>number of slots added, less if the schedule is full, 0 for an empty days mask or a slot that is not valid</returns>
+    uint8_t addDailySlot(unsigned long minuteOfDay, int temperature, unsigned long timeSpan, uint8_t days = allDays) {
+        uint8_t added = 0;
+        for (uint8_t weekday = 1; weekday <= 7; ++weekday) {
+            if ((days & (1u << (weekday - 1))) && addSlot(weekday, minuteOfDay, temperature, timeSpan)) {
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    void clear() {
+        count = 0;
+        armed = false;
+    }
+
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return Capacity; }
+    const ScheduleSlot& operator[](size_t index) const { return slots[index]; }
+
+    /// <summary>
+    /// Position of the first slot at or after the minute of the week, wraps around to the first slot of the week.
+    /// </summary>
+    size_t findNext(unsigned long minuteOfWeek) const {
+        size_t low = 0;
+        size_t high = count;
+        while (low < high) {
+            const size_t middle = (low + high) / 2;
+            if (slots[middle].minuteOfWeek < minuteOfWeek) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low < count ? low : 0;
+    }
+
+    /// <summary>
+    /// Call with the current minute of the week. Arms the next start on the first call,
+    /// starts in the past wait for the next week. A start is reached when it lies between the last call and now,
+    /// so a missed minute still starts it.
+    /// </summary>
+    /// <returns>the slot whose start was reached since the last call, nullptr otherwise</returns>
+    const ScheduleSlot* poll(unsigned long minuteOfWeek) {
+        if (count == 0) {
+            return nullptr;
+        }
+        minuteOfWeek %= minutesPerWeek;
+        if (!armed) {
+            // a start at this very minute is still reached
+            lastPoll = (minuteOfWeek + minutesPerWeek - 1) % minutesPerWeek;
+            armedIndex = findNext(minuteOfWeek);
+            armed = true;
+        }
+        unsigned long untilStart = minutesSince(lastPoll, slots[armedIndex].minuteOfWeek);
+        if (untilStart == 0) {
+            untilStart = minutesPerWeek;    // the only start of the week was just reached
+        }
+        if (minutesSince(lastPoll, minuteOfWeek) < untilStart) {
+            lastPoll = minuteOfWeek;
+            return nullptr;
+        }
+        // further starts since the last call are reached on the next calls
+        const ScheduleSlot* reached = &slots[armedIndex];
+        lastPoll = reached->minuteOfWeek;
+        armedIndex = findNext((reached->minuteOfWeek + 1) % minutesPerWeek);
+        return reached;
+    }
+
+    bool isArmed() const { return armed; }
+
+    // the armed slot, only valid while isArmed()
+    const ScheduleSlot& getArmedSlot() const { return slots[armedIndex]; }
+
+private:
+    static unsigned long minutesSince(unsigned long from, unsigned long to) {
+        return (to + minutesPerWeek - from) % minutesPerWeek;
+    }
+
+    ScheduleSlot slots[Capacity] = {};
+    size_t count = 0;
+    size_t armedIndex = 0;
+    unsigned long lastPoll = 0;     // minute of the week of the last call, or of the last reached start
+    bool armed = false;
+};
+
+// start schedule of the hay steamer, two starts a day
+using StartSchedule = WeeklySchedule<14>;
+
+#endif
@@ -17,7 +17,7 @@ class Communication
     Wlan_Connection wlan;
 };
 
-class NTP_Time : public Sensor<time_t>
+class NTP_Time final : public Sensor<time_t>
 {
   public:
   time_t read() override;
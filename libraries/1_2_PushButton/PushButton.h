@@ -17,9 +17,15 @@ class PushButton
     };
 
     void setup_push_button()
+    {
+      setup_push_button(push_button_is_pressed);
+    };
+
+    // button_ISR is called on every edge instead, it has to call push_button_is_pressed() to latch the press
+    void setup_push_button(voidFuncPtr button_ISR)
     {
       pinMode(pin_input, INPUT);
-      attachInterrupt(digitalPinToInterrupt(pin_input), push_button_is_pressed, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(pin_input), button_ISR, CHANGE);
     };
 
     bool is_pressed()
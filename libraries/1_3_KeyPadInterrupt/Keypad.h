@@ -7,7 +7,7 @@
 #include <I2CKeyPad.h>
 #include <Sensor.h>
 
-class Keypad : public Sensor<char>
+class Keypad final : public Sensor<char>
 {
   public:
     Keypad(const int& pin, const uint8_t& deviceAddress) 
@@ -1,29 +1,85 @@
 #ifndef TempProbe_h
 #define TempProbe_h
 
-#include <max6675.h>
-#include "Sensor.h"
+#include <Arduino.h>
 
-class TempProbe : public Sensor<int>
+// Pins of one MAX6675, the probes may share clock and data and differ only in chip select.
+struct TempProbePins {
+  int sck;
+  int cs;
+  int so;
+};
+
+// N MAX6675 thermocouple converters, read by bit-banged SPI.
+// A reading is split in two phases: a rising chip select starts a conversion, about 220 ms later
+// the result can be clocked out. Clocking it out earlier returns the previous value and restarts the conversion.
+// The readings are raw counts, ProbeSampler turns them into a Temperature.
+template<uint8_t N>
+class TempProbeArray
 {
   public:
-  TempProbe(const int& sck_pin1, const int& cs_pin1, const int& so_pin1, const int& sck_pin2, const int& cs_pin2, const int& so_pin2)
-    : thermocouple1(sck_pin1, cs_pin1, so_pin1)
-    , thermocouple2(sck_pin2, cs_pin2, so_pin2)
-  {};
+  static constexpr uint8_t probeCount = N;
+  static constexpr unsigned long conversionTime_ms = 220;
+  // the converter reports quarter degrees
+  static constexpr int countsPerDegree = 4;
 
-  int read() override
+  explicit TempProbeArray(const TempProbePins (&probePins)[N])
   {
-      temp1 = thermocouple1.readCelsius();
-      temp2 = thermocouple2.readCelsius();
-      return min(temp1, temp2);
+    for (uint8_t probe = 0; probe < N; ++probe) {
+      pins[probe] = probePins[probe];
+      pinMode(pins[probe].cs, OUTPUT);
+      pinMode(pins[probe].sck, OUTPUT);
+      pinMode(pins[probe].so, INPUT);
+      digitalWrite(pins[probe].cs, HIGH);
+    }
+  };
+
+  // start phase: selecting and deselecting the chip starts a new conversion
+  void startConversion(uint8_t probe)
+  {
+    digitalWrite(pins[probe].cs, LOW);
+    delayMicroseconds(10);
+    digitalWrite(pins[probe].cs, HIGH);
+  };
+
+  // collect phase: clocks out the finished conversion in quarter degrees, deselecting the chip starts the next one
+  // returns false if the thermocouple is open
+  bool collect(uint8_t probe, int& quarterDegrees)
+  {
+    const TempProbePins& p = pins[probe];
+    digitalWrite(p.cs, LOW);
+    delayMicroseconds(10);
+    uint16_t value = 0;
+    for (int8_t bit = 15; bit >= 0; --bit) {
+      digitalWrite(p.sck, LOW);
+      delayMicroseconds(10);
+      if (digitalRead(p.so)) {
+        value |= (1u << bit);
+      }
+      digitalWrite(p.sck, HIGH);
+      delayMicroseconds(10);
+    }
+    digitalWrite(p.cs, HIGH);
+
+    if (value & 0x4) {
+      return false;
+    }
+    // 12 bit in quarter degrees
+    quarterDegrees = value >> 3;
+    return true;
   };
 
   private:
-    MAX6675 thermocouple1;
-    int temp1 = 0;
-    MAX6675 thermocouple2;
-    int temp2 = 0;
+    TempProbePins pins[N];
+};
+
+// the two probes of the hay steamer
+class TempProbe final : public TempProbeArray<2>
+{
+  public:
+  TempProbe(const int& sck_pin1, const int& cs_pin1, const int& so_pin1, const int& sck_pin2, const int& cs_pin2, const int& so_pin2)
+    : TempProbeArray<2>({ { sck_pin1, cs_pin1, so_pin1 }, { sck_pin2, cs_pin2, so_pin2 } })
+  {};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -12,8 +12,28 @@ void setup() {
 
 void loop() {
   // put your main code here, to run repeatedly:
-  int minTemp = temp.read();
+  for (uint8_t probe = 0; probe < TempProbe::probeCount; ++probe) {
+    temp.startConversion(probe);
+  }
+  delay(TempProbe::conversionTime_ms);
+
+  // the lowest of the probes, in quarter degrees
+  bool any = false;
+  int minCounts = 0;
+  for (uint8_t probe = 0; probe < TempProbe::probeCount; ++probe) {
+    int counts = 0;
+    if (temp.collect(probe, counts) && (!any || counts < minCounts)) {
+      minCounts = counts;
+      any = true;
+    }
+  }
 
-  Serial.println(minTemp + "°C");
+  if (any) {
+    Serial.print(static_cast<float>(minCounts) / TempProbe::countsPerDegree);
+    Serial.println(" C");
+  }
+  else {
+    Serial.println("open thermocouple");
+  }
   delay(1000);
 }
@@ -6,7 +6,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 
-class Display : public Actor<String[4]>
+class Display final : public Actor<String[4]>
 {
   public:
   Display(int reset_pin)
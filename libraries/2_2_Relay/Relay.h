@@ -3,7 +3,7 @@
 
 #include <Actor.h>
 
-class Relay: public Actor<byte>
+class Relay final : public Actor<byte>
 {
   public:
     Relay(const int& pin)
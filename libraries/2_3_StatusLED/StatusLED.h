@@ -4,7 +4,7 @@
 #include <Status.h>
 #include <Actor.h>
 
-class StatusLED: public Actor<Status>
+class StatusLED final : public Actor<Status>
 {
   public:
     StatusLED(const int& red_in, const int& green_in, const int& blue_in)